@@ -16,14 +16,26 @@
 
 #include <bitcoin/system.hpp>
 #include <bitcoin/database/block_state.hpp>
+#include <bitcoin/database/codec.hpp>
 #include <bitcoin/database/data_base.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include <bitcoin/database/memory_pool.hpp>
+#include <bitcoin/database/perf_stats.hpp>
+#include <bitcoin/database/pool_expiry_filter.hpp>
+#include <bitcoin/database/prune_filter.hpp>
+#include <bitcoin/database/query_pool.hpp>
+#include <bitcoin/database/read_view.hpp>
+#include <bitcoin/database/reader.hpp>
 #include <bitcoin/database/settings.hpp>
 #include <bitcoin/database/store.hpp>
+#include <bitcoin/database/transaction_record.hpp>
 #include <bitcoin/database/unspent_outputs.hpp>
 #include <bitcoin/database/unspent_transaction.hpp>
 #include <bitcoin/database/verify.hpp>
 #include <bitcoin/database/version.hpp>
+#include <bitcoin/database/write_pressure.hpp>
+#include <bitcoin/database/result/block_iterator.hpp>
 #include <bitcoin/database/result/block_result.hpp>
 #include <bitcoin/database/result/filter_result.hpp>
 #include <bitcoin/database/result/inpoint_iterator.hpp>
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_CATALOG_INDEXER_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_CATALOG_INDEXER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/databases/block_database.hpp>
+#include <bitcoin/database/databases/transaction_database.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/optimistic_transaction_db.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// Builds the payment index of a range of confirmed blocks in parallel.
+/// Each chunk of blocks is written to a sorted table file and ingested into
+/// the payments family, bypassing the memtables and write-ahead log.
+class BCD_API catalog_indexer
+  : system::noncopyable
+{
+public:
+    /// Called with the height through which all blocks are indexed.
+    typedef std::function<void(size_t indexed, size_t top)> progress_handler;
+
+    /// Construct an indexer using threads, each indexing chunks of blocks.
+    catalog_indexer(std::shared_ptr<rocksdb::OptimisticTransactionDB> db,
+        const block_database& blocks,
+        const transaction_database& transactions,
+        rocksdb::ColumnFamilyHandle* payments_handle,
+        const boost::filesystem::path& directory, size_t threads,
+        size_t chunk_blocks);
+
+    /// Index confirmed blocks first through last, false if stopped or failed.
+    bool index(size_t first, size_t last, progress_handler handler);
+
+    /// Signal index to return (false) as soon as possible.
+    void stop();
+
+    /// Stop has been signaled.
+    bool stopped() const;
+
+private:
+    static void remove(const std::string& file);
+    bool index_chunk(size_t first, size_t last);
+
+    // These are thread safe.
+    std::shared_ptr<rocksdb::OptimisticTransactionDB> db_;
+    const block_database& blocks_;
+    const transaction_database& transactions_;
+    rocksdb::ColumnFamilyHandle* payments_handle_;
+    const boost::filesystem::path directory_;
+    const size_t threads_;
+    const size_t chunk_blocks_;
+    std::atomic<bool> stopped_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
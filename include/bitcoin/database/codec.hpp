@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_CODEC_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_CODEC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <bitcoin/system.hpp>
+#include "rocksdb/slice.h"
+
+namespace libbitcoin {
+namespace database {
+namespace codec {
+
+// Fixed-width records are described at compile time as a chain of fields,
+// each starting at the end of the previous. Integers are big-endian in keys
+// (so that keys order numerically) and little-endian in values. Fields are
+// read and written in place without allocation or bounds checks, so the
+// caller must verify the record size before decoding.
+
+/// The start of a record (a field of zero width).
+struct origin
+{
+    static constexpr size_t end = 0;
+};
+
+/// An unsigned integer field following Previous.
+template <typename Previous, typename Integer, bool BigEndian>
+struct integer
+{
+    static_assert(std::is_unsigned<Integer>::value, "unsigned integer");
+
+    static constexpr size_t offset = Previous::end;
+    static constexpr size_t size = sizeof(Integer);
+    static constexpr size_t end = offset + size;
+
+    static void put(uint8_t* record, Integer value)
+    {
+        const auto out = record + offset;
+        for (size_t byte = 0; byte < size; ++byte)
+            out[BigEndian ? size - 1 - byte : byte] =
+                static_cast<uint8_t>(value >> (8 * byte));
+    }
+
+    static Integer get(const uint8_t* record)
+    {
+        Integer value = 0;
+        const auto in = record + offset;
+        for (size_t byte = 0; byte < size; ++byte)
+            value = static_cast<Integer>(value | (static_cast<Integer>(
+                in[BigEndian ? size - 1 - byte : byte]) << (8 * byte)));
+
+        return value;
+    }
+};
+
+/// A big-endian integer field (keys).
+template <typename Previous, typename Integer>
+using big_endian = integer<Previous, Integer, true>;
+
+/// A little-endian integer field (values).
+template <typename Previous, typename Integer>
+using little_endian = integer<Previous, Integer, false>;
+
+/// A byte array field (e.g. a hash) following Previous.
+template <typename Previous, size_t Size>
+struct bytes
+{
+    typedef system::byte_array<Size> type;
+
+    static constexpr size_t offset = Previous::end;
+    static constexpr size_t size = Size;
+    static constexpr size_t end = offset + size;
+
+    static void put(uint8_t* record, const type& value)
+    {
+        std::copy_n(value.begin(), Size, record + offset);
+    }
+
+    static type get(const uint8_t* record)
+    {
+        type value;
+        std::copy_n(record + offset, Size, value.begin());
+        return value;
+    }
+
+    static uint8_t* data(uint8_t* record)
+    {
+        return record + offset;
+    }
+
+    static const uint8_t* data(const uint8_t* record)
+    {
+        return record + offset;
+    }
+};
+
+/// A record (key or value) ending with the Last field.
+template <typename Last>
+struct record
+{
+    static constexpr size_t size = Last::end;
+    typedef system::byte_array<size> type;
+};
+
+/// The bytes of a rocksdb slice, for decoding in place.
+inline const uint8_t* to_bytes(const rocksdb::Slice& value)
+{
+    return reinterpret_cast<const uint8_t*>(value.data());
+}
+
+/// The bytes of a rocksdb value, for decoding in place.
+inline const uint8_t* to_bytes(const std::string& value)
+{
+    return reinterpret_cast<const uint8_t*>(value.data());
+}
+
+} // namespace codec
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -20,12 +20,33 @@
 #define LIBBITCOIN_ROCKSDB_DATABASE_DATA_BASE_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include <bitcoin/system.hpp>
+#include <bitcoin/database/catalog_indexer.hpp>
+#include <bitcoin/database/perf_stats.hpp>
+#include <bitcoin/database/prune_filter.hpp>
+#include <bitcoin/database/query_pool.hpp>
+#include <bitcoin/database/read_view.hpp>
+#include <bitcoin/database/settings.hpp>
 #include <bitcoin/database/transaction_context.hpp>
+#include <bitcoin/database/write_pressure.hpp>
 #include <bitcoin/database/databases/block_database.hpp>
+#include <bitcoin/database/databases/filter_database.hpp>
+#include <bitcoin/database/databases/payment_database.hpp>
 #include <bitcoin/database/databases/transaction_database.hpp>
+#include <bitcoin/database/result/block_iterator.hpp>
+#include <bitcoin/database/result/block_result.hpp>
+#include "rocksdb/cache.h"
+#include "rocksdb/compaction_filter.h"
 #include "rocksdb/db.h"
+#include "rocksdb/write_buffer_manager.h"
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
 
@@ -38,11 +59,25 @@ class data_base
 public:
     const std::string TRANSACTIONS_COLUMN_FAMILY = "transactions";
     const std::string BLOCKS_COLUMN_FAMILY = "blocks";
+    const std::string BLOCK_STATE_COLUMN_FAMILY = "block_state";
     const std::string BLOCK_TRANSACTIONS_COLUMN_FAMILY = "block_transactions";
-    const size_t CACHE_CAPACITY = 10000;
+    const std::string TRANSACTION_METADATA_COLUMN_FAMILY = "transaction_metadata";
+    const std::string BLOCK_INDEX_COLUMN_FAMILY = "block_index";
+    const std::string PAYMENTS_COLUMN_FAMILY = "payments";
+    const std::string FILTERS_COLUMN_FAMILY = "filters";
+    const std::string POOL_COLUMN_FAMILY = "pool";
+
     typedef boost::filesystem::path path;
     typedef std::function<void(const system::code&)> result_handler;
-
+    typedef std::function<void(const system::code&, block_result)>
+        block_handler;
+    typedef std::function<void(const system::code&, transaction_result)>
+        transaction_handler;
+    typedef std::function<void(const system::code&,
+        const system::chain::output_point&)> output_handler;
+
+    /// Settings are applied when the store is created or opened.
+    data_base(const settings& settings);
     data_base(const path& directory, bool catalog, bool filter);
 
     // Open and close.
@@ -52,20 +87,123 @@ public:
     bool create(const system::chain::block& genesis);
 
     /// Open existing rocksdb database. Returns false if it doesn't exist.
+    /// If not closed cleanly, the most recent verify_depth blocks of each
+    /// index are verified, and divergent block state and tx confirmations
+    /// are repaired. Returns false if the store diverges irreparably.
+    /// The store is closed whenever false is returned.
     bool open();
 
-    /// Close all databases.
+    /// Close all databases. Returns false, leaving the store open, while
+    /// any read view (or block iterator or result reading through one) is
+    /// held. Returns false, with the store closed, if the close fails.
     bool close();
 
     /// Call close on destruct.
     ~data_base();
 
+    // Backup.
+    // ------------------------------------------------------------------------
+    // These are safe to call while the database is being written.
+
+    /// Create a consistent checkpoint (hard-linked files) at a new directory.
+    bool checkpoint(const path& directory) const;
+
+    /// Add an incremental backup to the backup directory and verify it,
+    /// false if the store is tiered (has data or family paths).
+    bool backup(const path& backup_directory, bool verify=true) const;
+
+    /// Restore the latest backup into directory (database must be closed).
+    static bool restore(const path& backup_directory, const path& directory);
+
+    // Compaction.
+    // ------------------------------------------------------------------------
+
+    /// Compact all families through the bottommost level, which applies
+    /// pruning (if pruning) and pool expiry to the whole store.
+    bool compact();
+
+    // Catalog.
+    // ------------------------------------------------------------------------
+    // Payments are indexed with each confirmation only while the catalog is
+    // live. A deferred catalog is built in bulk by index_catalog.
+
+    /// The payment index is maintained with each confirmation.
+    bool catalog_live() const;
+
+    /// Stop maintaining the payment index (e.g. for initial block download).
+    void defer_catalog();
+
+    /// Build the deferred payment index from confirmed blocks in the
+    /// background, then make the catalog live once caught up. False if
+    /// closed, live or building. Complete is called on the build thread
+    /// with the result, or with service_stopped by close, after which the
+    /// build may be started again.
+    bool index_catalog(size_t threads,
+        catalog_indexer::progress_handler progress,
+        result_handler complete=nullptr);
+
+    // Filters.
+    // ------------------------------------------------------------------------
+    // A filter commits to the filter of its previous block, so is stored
+    // with confirmation only if the previous is stored.
+
+    /// Build missing filters (e.g. with filtering enabled on an existing
+    /// store) in the background, through the confirmed top. Started by a
+    /// filter that cannot be stored, and confirmation skips filters until
+    /// complete. False if closed, not filtering or building. Complete is
+    /// called on the build thread (with service_stopped if closed).
+    bool index_filters(result_handler complete=nullptr);
+
     /// Database transaction interface
     // ------------------------------------------------------------------------
     std::shared_ptr<transaction_context> begin_transaction(
         bool use_snapshot = false);
     bool commit_transaction(std::shared_ptr<transaction_context> txn);
 
+    /// Read interface
+    // ------------------------------------------------------------------------
+
+    /// A consistent snapshot for queries, without a transaction, which must
+    /// be released before close.
+    std::shared_ptr<read_view> begin_read(bool fill_cache=true,
+        size_t readahead=0) const;
+
+    /// A consistent snapshot for a bulk pass over history (a rescan or an
+    /// index build), which does not fill the block cache and reads ahead.
+    std::shared_ptr<read_view> begin_scan() const;
+
+    /// Stream the confirmed blocks from first through last height, from a
+    /// scan snapshot (for serving history).
+    block_iterator read_blocks(size_t first, size_t last) const;
+
+    /// Visit each stored (not pooled or pruned) transaction in hash order
+    /// from a scan snapshot, until the visitor returns false. Returns false
+    /// if closed, stopped or the scan fails.
+    bool scan_transactions(transaction_database::visitor handler) const;
+
+    /// Asynchronous queries.
+    // ------------------------------------------------------------------------
+    // Each reads from its own snapshot on a query thread and completes on
+    // that thread, with not_found, or oversubscribed if too many are in
+    // flight, or service_stopped if closed.
+
+    /// Fetch block by hash.
+    void get_block(const system::hash_digest& hash,
+        block_handler handler) const;
+
+    /// Fetch block by candidate|confirmed index height.
+    void get_block(size_t height, bool candidate,
+        block_handler handler) const;
+
+    /// Fetch transaction by hash.
+    void get_transaction(const system::hash_digest& hash,
+        transaction_handler handler) const;
+
+    /// Populate output metadata of a copy of the point relative to fork
+    /// height, which is passed to the handler (the point is not written).
+    void get_output(const system::chain::output_point& point,
+        size_t fork_height, output_handler handler) const;
+
     /// Reader interfaces.
     // ------------------------------------------------------------------------
     // These are const to preclude write operations by public callers.
@@ -73,6 +211,11 @@ public:
     // Node writers.
     // ------------------------------------------------------------------------
 
+    // BLOCK ORGANIZER (receive)
+    /// Cache the stored previous outputs of the block in the background,
+    /// false if not queued (closed or too many blocks queued).
+    bool prefetch(system::block_const_ptr block);
+
     // INITCHAIN (genesis)
     /// Push the block through candidacy and confirmation, without indexing.
     system::code push(std::shared_ptr<transaction_context> context,
@@ -122,6 +265,8 @@ public:
 
     std::shared_ptr<block_database> blocks_;
     std::shared_ptr<transaction_database> transactions_;
+    std::shared_ptr<payment_database> payments_;
+    std::shared_ptr<filter_database> filters_;
 
     /// Reader interfaces.
     // ------------------------------------------------------------------------
@@ -131,9 +276,76 @@ public:
 
     const transaction_database& transactions() const;
 
+    /// Empty unless catalog is enabled.
+    const payment_database& payments() const;
+
+    /// Empty unless filter is enabled.
+    const filter_database& filters() const;
+
+    /// Sampled rocksdb stats of commits, output and block reads.
+    const perf_stats& stats() const;
+
+    /// Write stall, flush and compaction counters of the store.
+    const write_pressure& pressure() const;
+
+    /// Writes are stalled or compaction debt exceeds the configured limit,
+    /// so block download should slow.
+    bool backpressure() const;
+
 private:
-    // system::chain::transaction::list to_transactions(
-    //     const block_result& result) const;
+    bool open(const rocksdb::Options& options);
+    void start_pools();
+    void prune(size_t top);
+
+    rocksdb::Options database_options() const;
+    rocksdb::ColumnFamilyOptions column_family_options(
+        const std::string& name, size_t families) const;
+    std::vector<rocksdb::ColumnFamilyDescriptor> column_families() const;
+
+    rocksdb::ColumnFamilyHandle* handle(const std::string& name) const;
+
+    system::code catalog(std::shared_ptr<transaction_context> context,
+        const system::chain::block& block, size_t height);
+    system::code uncatalog(std::shared_ptr<transaction_context> context,
+        const system::chain::block& block);
+    system::code index(std::shared_ptr<transaction_context> context,
+        const system::chain::block& block, size_t height);
+
+    // Build the filter of the block on another thread, if filtering.
+    std::future<bool> build_filter(
+        std::shared_ptr<transaction_context> context,
+        const system::chain::block& block, system::data_chunk& out_filter);
+    bool filter(std::shared_ptr<transaction_context> context,
+        const system::chain::block& block, std::future<bool>& built,
+        const system::data_chunk& filter);
+
+    // Runs on the filter thread.
+    system::code build_filters();
+    void stop_filters();
+
+    // The height through which payments are indexed, false if none.
+    bool catalog_height(std::shared_ptr<transaction_context> context,
+        size_t& out_height) const;
+    bool set_catalog_height(std::shared_ptr<transaction_context> context,
+        size_t height);
+
+    // Runs on the indexer thread.
+    system::code build_catalog(catalog_indexer::progress_handler handler);
+    bool stop_catalog();
+
+    // The store was closed cleanly, clears the marker until the next close.
+    bool clean_shutdown();
+    bool set_clean_shutdown();
+
+    // Wait out backpressure, if throttling writes.
+    void throttle() const;
+
+    // Verify the most recent blocks of each index, repairing if possible.
+    bool recover();
+    bool repair(std::shared_ptr<transaction_context> context, size_t height,
+        bool candidate);
+
+    const settings settings_;
 
     // Path to db directory
     path directory_;
@@ -145,6 +357,55 @@ private:
     const bool catalog_;
     const bool filter_;
 
+    // Memory shared by all column families, bounded by the memory budget.
+    std::shared_ptr<rocksdb::Cache> block_cache_;
+    std::shared_ptr<rocksdb::WriteBufferManager> write_buffer_manager_;
+
+    // Drops expired pool records, must outlive the store.
+    std::unique_ptr<rocksdb::CompactionFilter> pool_expiry_;
+
+    // Prune records of blocks beyond the prune depth (if pruning), must
+    // outlive the store.
+    std::shared_ptr<prune_filter> prune_transactions_;
+    std::shared_ptr<prune_filter> prune_block_transactions_;
+    std::shared_ptr<prune_filter> prune_filters_;
+
+    // The catalog is live unless deferred, mutex excludes confirmation
+    // while the deferred catalog build catches up and makes it live.
+    std::atomic<bool> catalog_live_;
+    mutable system::shared_mutex catalog_mutex_;
+
+    // The catalog build, these are protected by indexer mutex.
+    std::shared_ptr<catalog_indexer> indexer_;
+    std::thread indexer_thread_;
+    size_t indexer_threads_;
+    catalog_indexer::progress_handler indexer_progress_;
+    result_handler indexer_complete_;
+    system::code indexer_result_;
+    std::atomic<bool> indexing_;
+    std::mutex indexer_mutex_;
+
+    // The filter build, the thread is protected by filter mutex. While there
+    // is a gap, confirmation does not build filters.
+    std::thread filter_thread_;
+    std::atomic<bool> filtering_;
+    std::atomic<bool> filters_stopped_;
+    std::atomic<bool> filter_gap_;
+    std::mutex filter_mutex_;
+
+    // Sampled operation stats, must outlive the databases.
+    perf_stats stats_;
+
+    // Listens to rocksdb write stalls, flushes and compactions.
+    std::shared_ptr<write_pressure> pressure_;
+
+    // Not known to diverge, so marked as cleanly shut down on close.
+    std::atomic<bool> consistent_;
+
+    // Run asynchronous queries and prefetches while open.
+    std::shared_ptr<query_pool> queries_;
+    std::shared_ptr<query_pool> prefetches_;
+
     // rocksdb column families for all databases
     std::vector<rocksdb::ColumnFamilyHandle*> column_family_handles_;
 };
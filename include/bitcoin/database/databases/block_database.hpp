@@ -23,9 +23,11 @@
 #include <cstddef>
 #include <boost/filesystem.hpp>
 #include <bitcoin/system.hpp>
+#include <bitcoin/database/reader.hpp>
 #include <bitcoin/database/transaction_context.hpp>
 #include <bitcoin/database/block_state.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/perf_stats.hpp>
 #include <bitcoin/database/result/block_result.hpp>
 #include "rocksdb/db.h"
 #include "rocksdb/utilities/transaction.h"
@@ -34,33 +36,43 @@
 namespace libbitcoin {
 namespace database {
 
-/// Stores block_headers each with a list of transaction indexes.
-/// Lookup possible by hash or height.
+/// Stores block_headers each with a list of transaction hashes.
+/// Lookup possible by hash or height (candidate and confirmed indexes).
+/// Header records are immutable, block state is stored apart.
 class BCD_API block_database
 {
 public:
     /// Construct the database.
     block_database(std::shared_ptr<rocksdb::OptimisticTransactionDB> db_,
         rocksdb::ColumnFamilyHandle* block_handle_,
-        rocksdb::ColumnFamilyHandle* block_transactions_handle_);
+        rocksdb::ColumnFamilyHandle* block_state_handle_,
+        rocksdb::ColumnFamilyHandle* block_transactions_handle_,
+        rocksdb::ColumnFamilyHandle* block_index_handle_,
+        perf_stats& stats);
 
     // Queries.
     //-------------------------------------------------------------------------
+    // These read through a transaction context or a read view.
 
     /// The height of the highest candidate|confirmed block.
-    bool top(std::shared_ptr<transaction_context> context,
+    bool top(std::shared_ptr<reader> context,
         size_t& out_height, bool candidate) const;
 
     /// Fetch block by block|header index height.
-    block_result get(std::shared_ptr<transaction_context> context,
-        size_t height, bool candidate) const;
+    block_result get(std::shared_ptr<reader> context, size_t height,
+        bool candidate) const;
 
     /// Fetch block by hash.
-    block_result get(std::shared_ptr<transaction_context> context,
+    block_result get(std::shared_ptr<reader> context,
         const system::hash_digest& hash) const;
 
+    /// Hashes of the candidate|confirmed index from first through last
+    /// height, truncated at the first missing height.
+    system::hash_list get_hashes(std::shared_ptr<reader> context,
+        size_t first, size_t last, bool candidate) const;
+
     /// Populate header metadata for the given header.
-    void get_header_metadata(std::shared_ptr<transaction_context> context,
+    void get_header_metadata(std::shared_ptr<reader> context,
         const system::chain::header& header) const;
 
     // Writers.
@@ -93,9 +105,25 @@ private:
         const system::chain::header& header, size_t height,
         uint32_t median_time_past, uint32_t checksum, uint8_t status);
 
+    // Read the hash at the height of the candidate|confirmed index.
+    bool read_index(std::shared_ptr<reader> context,
+        size_t height, bool candidate, system::hash_digest& out_hash) const;
+
+    // Read the state and checksum of the block, without its header.
+    bool read_state(std::shared_ptr<reader> context,
+        const system::hash_digest& hash, uint8_t& out_state,
+        uint32_t& out_checksum) const;
+
+    // Write the state and checksum of the block (header is unchanged).
+    bool update_state(std::shared_ptr<transaction_context> context,
+        const system::hash_digest& hash, uint8_t state, uint32_t checksum);
+
     std::shared_ptr<rocksdb::OptimisticTransactionDB> db_;
     rocksdb::ColumnFamilyHandle* block_handle_;
+    rocksdb::ColumnFamilyHandle* block_state_handle_;
     rocksdb::ColumnFamilyHandle* block_transactions_handle_;
+    rocksdb::ColumnFamilyHandle* block_index_handle_;
+    perf_stats& stats_;
 };
 
 } // namespace database
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_FILTER_DATABASE_HPP
+#define LIBBITCOIN_DATABASE_FILTER_DATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/reader.hpp>
+#include <bitcoin/database/transaction_context.hpp>
+#include <bitcoin/database/databases/block_database.hpp>
+#include <bitcoin/database/result/filter_result.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/transaction.h"
+#include "rocksdb/utilities/optimistic_transaction_db.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// Stores the compact block filter (BIP158) and filter header of each
+/// confirmed block, keyed by block hash. Filters survive reorganization
+/// since a filter header commits only to the block's own ancestry.
+class BCD_API filter_database
+{
+public:
+    /// The basic filter type, the only type stored.
+    static const uint8_t basic_filter_type;
+
+    /// Construct the database.
+    filter_database(std::shared_ptr<rocksdb::OptimisticTransactionDB> db_,
+        rocksdb::ColumnFamilyHandle* handle_, const block_database& blocks_);
+
+    /// Compute the basic filter of the block, inputs require populated
+    /// prevouts. This does not touch the store, so may run on any thread.
+    static bool compute(const system::chain::block& block,
+        system::data_chunk& out_filter);
+
+    // Queries.
+    //-------------------------------------------------------------------------
+
+    /// Fetch the filter of the block.
+    filter_result get(std::shared_ptr<reader> context,
+        const system::hash_digest& block_hash) const;
+
+    /// Filters of the confirmed blocks from start_height through stop_hash,
+    /// as requested by getcfilters and getcfheaders. Empty if stop_hash is
+    /// not confirmed at or above start_height, the range exceeds limit or
+    /// any filter in the range is missing.
+    std::vector<filter_result> get(std::shared_ptr<reader> context,
+        size_t start_height, const system::hash_digest& stop_hash,
+        size_t limit) const;
+
+    // Writers.
+    // ------------------------------------------------------------------------
+
+    /// Store the filter of the block with its header, which commits to the
+    /// stored filter header of the previous block.
+    bool store(std::shared_ptr<transaction_context> context,
+        const system::chain::header& header, const system::data_chunk& filter);
+
+private:
+    std::shared_ptr<rocksdb::OptimisticTransactionDB> db_;
+    rocksdb::ColumnFamilyHandle* handle_;
+    const block_database& blocks_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_PAYMENT_DATABASE_HPP
+#define LIBBITCOIN_DATABASE_PAYMENT_DATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include <bitcoin/database/reader.hpp>
+#include <bitcoin/database/transaction_context.hpp>
+#include <bitcoin/database/result/payment_iterator.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/transaction.h"
+#include "rocksdb/utilities/optimistic_transaction_db.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// Stores the payments (outputs and spends) of transactions, keyed by the
+/// sha256 hash of the output script, newest first within each script hash.
+class BCD_API payment_database
+{
+public:
+    /// Payment index keys and values.
+    typedef std::vector<std::pair<payment_key::record::type, uint64_t>>
+        rows;
+
+    /// Construct the database.
+    payment_database(std::shared_ptr<rocksdb::OptimisticTransactionDB> db_,
+        rocksdb::ColumnFamilyHandle* handle_);
+
+    /// The hash under which payments to the output script are indexed.
+    static system::hash_digest to_script_hash(
+        const system::chain::script& script);
+
+    /// The index rows of the payments of the tx, inputs require populated
+    /// prevouts. Used directly to build sorted tables for bulk ingestion.
+    static rows to_rows(const system::chain::transaction& tx, size_t height,
+        size_t position);
+
+    /// The stored form of a payment value.
+    static payment_value::record::type to_value(uint64_t value);
+
+    // Queries.
+    //-------------------------------------------------------------------------
+
+    /// Payments of the script hash, newest first, resuming after the cursor
+    /// (the cursor of the last payment of the previous page) if not empty.
+    payment_iterator get(std::shared_ptr<reader> context,
+        const system::hash_digest& script_hash,
+        const system::data_chunk& cursor={},
+        size_t limit=max_size_t) const;
+
+    /// The tx has payments indexed at height/position (its first output).
+    bool cataloged(std::shared_ptr<reader> context,
+        const system::chain::transaction& tx, size_t height,
+        size_t position) const;
+
+    // Writers.
+    // ------------------------------------------------------------------------
+
+    /// Index the payments of the tx, inputs require populated prevouts.
+    bool catalog(std::shared_ptr<transaction_context> context,
+        const system::chain::transaction& tx, size_t height,
+        size_t position);
+
+    /// Remove the payments of the tx previously indexed at height/position.
+    bool uncatalog(std::shared_ptr<transaction_context> context,
+        const system::chain::transaction& tx, size_t height,
+        size_t position);
+
+private:
+    std::shared_ptr<rocksdb::OptimisticTransactionDB> db_;
+    rocksdb::ColumnFamilyHandle* handle_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -20,9 +20,14 @@
 #define LIBBITCOIN_DATABASE_TRANSACTION_DATABASE_HPP
 
 #include <cstddef>
+#include <functional>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <bitcoin/system.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/memory_pool.hpp>
+#include <bitcoin/database/perf_stats.hpp>
+#include <bitcoin/database/reader.hpp>
 #include <bitcoin/database/transaction_context.hpp>
 #include <bitcoin/database/result/transaction_result.hpp>
 #include <bitcoin/database/unspent_outputs.hpp>
@@ -35,44 +40,82 @@ namespace database {
 
 // Store transactions keyed by transaction hash.
 // Block to transaction association is stored in block database.
+// Metadata (height, position, candidate, median time past) is kept in its
+// own column family so that metadata reads and updates never touch the
+// (potentially blob-separated) transaction body. Unconfirmed transactions
+// not associated with a block are kept apart, in an expiring pool family
+// (or only in memory), and moved to the transaction family once in a block.
 class BCD_API transaction_database
 {
 public:
-    /// Construct the database.
+    typedef std::function<bool(const system::chain::transaction&)> visitor;
+
+    /// Construct the database, the pool is in memory if pool_handle_ is null.
     transaction_database(std::shared_ptr<rocksdb::OptimisticTransactionDB> db_,
         rocksdb::ColumnFamilyHandle* handle_,
-        size_t cache_capacity);
+        rocksdb::ColumnFamilyHandle* metadata_handle_,
+        rocksdb::ColumnFamilyHandle* pool_handle_, size_t cache_capacity,
+        size_t cache_spent_window, uint32_t pool_expiry,
+        size_t pool_capacity, perf_stats& stats);
 
     // Queries.
     //-------------------------------------------------------------------------
+    // These read through a transaction context or a read view.
 
     /// Fetch transaction by its hash.
-    transaction_result get(std::shared_ptr<transaction_context> context,
+    transaction_result get(std::shared_ptr<reader> context,
         const system::hash_digest& hash) const;
 
+    /// Fetch transactions by hash, empty if any is missing or pruned.
+    system::chain::transaction::list get(std::shared_ptr<reader> context,
+        const system::hash_list& hashes) const;
+
     /// Populate tx metadata for the given block context.
-    void get_block_metadata(std::shared_ptr<transaction_context> context,
+    void get_block_metadata(std::shared_ptr<reader> context,
         const system::chain::transaction& tx,
         uint32_t forks, size_t fork_height) const;
 
     /// Populate tx metadata for the given transaction pool context.
-    void get_pool_metadata(std::shared_ptr<transaction_context> context,
+    void get_pool_metadata(std::shared_ptr<reader> context,
         const system::chain::transaction& tx,
         uint32_t forks) const;
 
     /// Populate output metadata for the specified point and fork point.
-    bool get_output(std::shared_ptr<transaction_context> context,
+    bool get_output(std::shared_ptr<reader> context,
         const system::chain::output_point& point,
         size_t fork_height) const;
 
+    /// Populate output metadata for any unpopulated previous outputs of tx.
+    void get_prevouts(std::shared_ptr<reader> context,
+        const system::chain::transaction& tx, size_t fork_height) const;
+
+    /// Visit each stored (not pooled or pruned) tx in hash order, in one pass
+    /// over the family, until the visitor returns false. Returns false if
+    /// stopped or the pass fails.
+    bool scan(std::shared_ptr<reader> context, visitor handler) const;
+
+    /// Visit each unexpired pooled tx, until the visitor returns false.
+    /// Returns false if stopped or the pass fails.
+    bool scan_pool(std::shared_ptr<reader> context, visitor handler) const;
+
+    // Cache.
+    // ------------------------------------------------------------------------
+
+    /// Read the stored previous outputs spent by the block, in batches, and
+    /// add them to the unspent output cache ahead of validation. Returns the
+    /// number of previous transactions cached.
+    size_t prefetch(std::shared_ptr<reader> context,
+        const system::chain::block& block);
+
     // Writers.
     // ------------------------------------------------------------------------
 
-    /// Store a transaction not associated with a block.
+    /// Pool a transaction not associated with a block.
     bool store(std::shared_ptr<transaction_context> context,
         const system::chain::transaction& tx, uint32_t forks);
 
-    /// Store a set of transactions (potentially from an unconfirmed block).
+    /// Store a set of transactions (potentially from an unconfirmed block),
+    /// moving any that are pooled.
     bool store(std::shared_ptr<transaction_context> context,
         const system::chain::transaction::list& transactions);
 
@@ -101,36 +144,60 @@ public:
 private:
     typedef system::hash_digest key_type;
 
+    // Stored transaction metadata.
+    struct metadata
+    {
+        uint32_t height;
+        uint16_t position;
+        bool candidate;
+        uint32_t median_time_past;
+    };
+
+    // Read and write the metadata record.
+    //-------------------------------------------------------------------------
+    static bool to_metadata(const std::string& value,
+        metadata& out_metadata);
+    bool read_metadata(std::shared_ptr<reader> context,
+        const system::hash_digest& hash, metadata& out_metadata) const;
+    bool write_metadata(std::shared_ptr<transaction_context> context,
+        const system::hash_digest& hash, const metadata& value);
+
     // Store a transaction.
     //-------------------------------------------------------------------------
-    bool storize(const system::chain::transaction& tx, size_t height,
+    bool storize(std::shared_ptr<transaction_context> context,
+        const system::chain::transaction& tx, size_t height,
         uint32_t median_time_past, size_t position);
 
-    // Update the candidate state of the tx.
+    // Read, write and remove the pooled tx.
     //-------------------------------------------------------------------------
-    bool candidate(const system::hash_digest& hash, bool positive);
-
-    // Update the candidate spent of the output.
-    bool candidate_spend(const system::chain::output_point& point,
-        bool positive);
+    bool read_pool(std::shared_ptr<reader> context,
+        const system::hash_digest& hash, uint32_t& out_forks,
+        system::data_chunk& out_body) const;
+    bool write_pool(std::shared_ptr<transaction_context> context,
+        const system::chain::transaction& tx, uint32_t forks);
+    bool unpool(std::shared_ptr<transaction_context> context,
+        const system::hash_digest& hash);
 
     // Update the candidate metadata of the existing tx.
-    bool candidize(const system::hash_digest& hash, bool positive);
-
-    // Update the spender height of the output.
     //-------------------------------------------------------------------------
-    bool confirmed_spend(const system::chain::output_point& point,
-        size_t spender_height);
+    bool candidize(std::shared_ptr<transaction_context> context,
+        const system::hash_digest& hash, bool positive);
 
     // Promote metadata of the existing tx to confirmed.
-    bool confirmize(const system::hash_digest& hash, size_t height, uint32_t median_time_past,
-        size_t position);
+    bool confirmize(std::shared_ptr<transaction_context> context,
+        const system::hash_digest& hash, size_t height,
+        uint32_t median_time_past, size_t position);
 
     std::shared_ptr<rocksdb::OptimisticTransactionDB> db_;
     rocksdb::ColumnFamilyHandle* handle_;
+    rocksdb::ColumnFamilyHandle* metadata_handle_;
+    rocksdb::ColumnFamilyHandle* pool_handle_;
+    const uint32_t pool_expiry_;
 
-    // This is thread safe.
+    // These are thread safe.
     unspent_outputs cache_;
+    memory_pool pool_;
+    perf_stats& stats_;
 };
 
 } // namespace database
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_LAYOUTS_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_LAYOUTS_HPP
+
+#include <cstdint>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/codec.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+// Record layouts of the column families. Keys are big-endian, values are
+// little-endian. Variable-width records have a fixed prefix layout, followed
+// by the variable part (at prefix::size).
+
+/// Block index key: candidate|confirmed index, height.
+struct block_index_key
+{
+    typedef codec::big_endian<codec::origin, uint8_t> index;
+    typedef codec::big_endian<index, uint32_t> height;
+    typedef codec::record<height> record;
+};
+
+/// Block value (immutable): header, median time past, height.
+struct block_value
+{
+    static constexpr size_t header_size = 80;
+
+    typedef codec::bytes<codec::origin, header_size> header;
+    typedef codec::little_endian<header, uint32_t> median_time_past;
+    typedef codec::little_endian<median_time_past, uint32_t> height;
+    typedef codec::record<height> record;
+};
+
+/// Block state value (mutable): state, checksum (validation error code).
+struct block_state_value
+{
+    typedef codec::little_endian<codec::origin, uint8_t> state;
+    typedef codec::little_endian<state, uint32_t> checksum;
+    typedef codec::record<checksum> record;
+};
+
+/// Transaction metadata value: height, position, candidate, mtp.
+struct metadata_value
+{
+    typedef codec::little_endian<codec::origin, uint32_t> height;
+    typedef codec::little_endian<height, uint16_t> position;
+    typedef codec::little_endian<position, uint8_t> candidate;
+    typedef codec::little_endian<candidate, uint32_t> median_time_past;
+    typedef codec::record<median_time_past> record;
+};
+
+/// Pooled transaction value prefix: pooled time, forks (then tx body).
+struct pool_prefix
+{
+    typedef codec::little_endian<codec::origin, uint32_t> time;
+    typedef codec::little_endian<time, uint32_t> forks;
+    typedef codec::record<forks> record;
+};
+
+/// Payment key: script hash, ~height, ~position, ~(input flag | index),
+/// tx hash. Inverted fields order each script hash history newest first.
+struct payment_key
+{
+    typedef codec::bytes<codec::origin, system::hash_size> script_hash;
+    typedef codec::big_endian<script_hash, uint32_t> height;
+    typedef codec::big_endian<height, uint16_t> position;
+    typedef codec::big_endian<position, uint32_t> point;
+    typedef codec::bytes<point, system::hash_size> hash;
+    typedef codec::record<hash> record;
+};
+
+/// Payment value: output value.
+struct payment_value
+{
+    typedef codec::little_endian<codec::origin, uint64_t> value;
+    typedef codec::record<value> record;
+};
+
+/// Filter value prefix: filter type, filter header (then filter).
+struct filter_prefix
+{
+    typedef codec::little_endian<codec::origin, uint8_t> type;
+    typedef codec::bytes<type, system::hash_size> header;
+    typedef codec::record<header> record;
+};
+
+/// Catalog height value (default family).
+struct catalog_height_value
+{
+    typedef codec::little_endian<codec::origin, uint32_t> height;
+    typedef codec::record<height> record;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_ROCKSDB_MEMORY_POOL_HPP
+#define LIBBITCOIN_DATABASE_ROCKSDB_MEMORY_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/bimap.hpp>
+#include <boost/bimap/multiset_of.hpp>
+#include <boost/bimap/unordered_set_of.hpp>
+#include <boost/functional/hash.hpp>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// An expiring hash table of [tx hash, stored unconfirmed tx], used in place
+/// of the pool column family when the pool is not persisted. The oldest
+/// entries are evicted to keep the pool within its capacity in bytes.
+class BCD_API memory_pool
+  : system::noncopyable
+{
+public:
+    /// Construct a pool with the specified entry lifetime in seconds and
+    /// capacity in bytes (of entries, with their stored txs).
+    memory_pool(uint32_t expiry, size_t capacity=system::max_size_t);
+
+    /// The number of transactions in the pool.
+    size_t size() const;
+
+    /// The bytes of the entries in the pool.
+    size_t bytes() const;
+
+    /// Add the stored form of the tx, verified with forks, at time, and
+    /// remove any entries that have expired at that time, then the oldest
+    /// entries (possibly this) while over capacity.
+    void add(const system::hash_digest& hash, uint32_t forks,
+        const system::data_chunk& body, uint32_t time);
+
+    /// Remove the tx (confirmed).
+    void remove(const system::hash_digest& hash);
+
+    /// Find the unexpired tx, false if not found.
+    bool find(const system::hash_digest& hash, uint32_t& out_forks,
+        system::data_chunk& out_body, uint32_t time) const;
+
+    /// The stored forms of all unexpired txs.
+    system::data_stack bodies(uint32_t time) const;
+
+private:
+    struct entry
+    {
+        uint32_t forks;
+        system::data_chunk body;
+    };
+
+    // Entries are ordered by time added, so expiry removes from the front.
+    typedef boost::bimaps::bimap<
+        boost::bimaps::unordered_set_of<system::hash_digest,
+            boost::hash<system::hash_digest>>,
+        boost::bimaps::multiset_of<uint32_t>,
+        boost::bimaps::with_info<entry>> pooled_transactions;
+
+    static size_t entry_bytes(const system::data_chunk& body);
+
+    // These are thread safe.
+    const uint32_t expiry_;
+    const size_t capacity_;
+
+    // These are protected by mutex.
+    pooled_transactions pool_;
+    size_t bytes_;
+    mutable system::shared_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
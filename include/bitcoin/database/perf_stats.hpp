@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_PERF_STATS_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_PERF_STATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include "rocksdb/perf_level.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// Samples the rocksdb perf and io stats contexts around store operations,
+/// one in every rate calls of each operation, aggregated per operation and
+/// logged every log interval. Unsampled calls cost an atomic increment.
+class BCD_API perf_stats
+  : system::noncopyable
+{
+public:
+    enum operation : uint8_t
+    {
+        commit,
+        get_output,
+        get_block
+    };
+
+    static constexpr size_t operations = 3;
+
+    /// The counters of the sampled calls of an operation.
+    struct totals
+    {
+        uint64_t calls;
+        uint64_t samples;
+        uint64_t elapsed_nanoseconds;
+
+        /// Perf context (reads).
+        uint64_t block_cache_hits;
+        uint64_t block_reads;
+        uint64_t block_read_bytes;
+        uint64_t bloom_filter_hits;
+        uint64_t bloom_filter_misses;
+        uint64_t memtable_reads;
+
+        /// Perf context (writes).
+        uint64_t write_stall_nanoseconds;
+        uint64_t wal_write_nanoseconds;
+        uint64_t memtable_write_nanoseconds;
+
+        /// IO stats context.
+        uint64_t io_read_bytes;
+        uint64_t io_write_bytes;
+        uint64_t fsync_nanoseconds;
+    };
+
+    /// Samples the calling thread for its scope, if selected by the rate.
+    /// Samples do not nest, an inner sample of the same thread is skipped.
+    class BCD_API sample
+      : system::noncopyable
+    {
+    public:
+        sample(perf_stats& stats, operation op);
+        ~sample();
+
+    private:
+        perf_stats& stats_;
+        const operation operation_;
+        const bool sampled_;
+        rocksdb::PerfLevel level_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /// Sample one in rate calls of each operation (zero disables sampling),
+    /// logging the totals every log interval seconds (zero disables logs).
+    perf_stats(size_t rate, uint32_t log_interval_seconds);
+
+    /// Sampling is enabled.
+    bool enabled() const;
+
+    /// The totals of the operation.
+    totals get(operation op) const;
+
+    /// The totals of all operations, one line each.
+    std::string to_string() const;
+
+private:
+    bool begin(operation op);
+    void end(operation op, uint64_t elapsed_nanoseconds);
+
+    const size_t rate_;
+    const std::chrono::seconds log_interval_;
+    std::atomic<uint64_t> calls_[operations];
+
+    // These are protected by mutex.
+    totals totals_[operations];
+    std::chrono::steady_clock::time_point logged_;
+    mutable system::shared_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
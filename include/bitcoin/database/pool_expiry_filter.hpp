@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_ROCKSDB_POOL_EXPIRY_FILTER_HPP
+#define LIBBITCOIN_DATABASE_ROCKSDB_POOL_EXPIRY_FILTER_HPP
+
+#include <cstdint>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/slice.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// Drops pool family records older than the expiry during compaction, so
+/// evicted and never-mined transactions do not accumulate in the store.
+/// Records begin with the 4 byte little-endian time the tx was pooled.
+class BCD_API pool_expiry_filter
+  : public rocksdb::CompactionFilter
+{
+public:
+    /// Construct a filter with the specified record lifetime in seconds.
+    pool_expiry_filter(uint32_t expiry);
+
+    /// The time of the pool record (zero if malformed).
+    static uint32_t pooled_time(const rocksdb::Slice& value);
+
+    /// The current time, as written to pool records.
+    static uint32_t now();
+
+    bool Filter(int level, const rocksdb::Slice& key,
+        const rocksdb::Slice& existing_value, std::string* new_value,
+        bool* value_changed) const override;
+
+    const char* Name() const override;
+
+private:
+    const uint32_t expiry_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
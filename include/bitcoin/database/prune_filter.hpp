@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_ROCKSDB_PRUNE_FILTER_HPP
+#define LIBBITCOIN_DATABASE_ROCKSDB_PRUNE_FILTER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/db.h"
+#include "rocksdb/slice.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// Prunes the records of blocks below the prune height during compaction.
+/// Confirmed transaction bodies are reduced to their outputs (so that they
+/// remain spendable), and block transaction and filter records are dropped.
+/// The height of each record is read from its block or transaction metadata,
+/// so records are retained while the store is not open. Only compactions
+/// into the bottommost level are filtered, where nearly all records are, so
+/// that heights are not read again as records move through the upper levels.
+class BCD_API prune_filter
+  : public rocksdb::CompactionFilterFactory
+{
+public:
+    /// The family of the filtered records.
+    enum class family
+    {
+        transactions,
+        block_transactions,
+        filters
+    };
+
+    /// Construct a filter of the family, which prunes nothing until open.
+    prune_filter(family records);
+
+    /// Read heights from the open store (handles must outlive close).
+    void open(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* blocks_handle,
+        rocksdb::ColumnFamilyHandle* metadata_handle);
+
+    /// Stop reading heights, waits for filters in progress.
+    void close();
+
+    /// Records below this height are pruned (zero prunes nothing).
+    size_t height() const;
+    void set_height(size_t height);
+
+    /// Prune the record, as rocksdb::CompactionFilter::Filter.
+    bool filter(const rocksdb::Slice& key,
+        const rocksdb::Slice& existing_value, std::string* new_value,
+        bool* value_changed) const;
+
+    /// A filter of a bottommost compaction, otherwise null (no filter).
+    std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+        const rocksdb::CompactionFilter::Context& context) override;
+
+    const char* Name() const override;
+
+private:
+    class compaction;
+
+    bool read(const rocksdb::Slice& key, std::string& value) const;
+    bool prunable(const rocksdb::Slice& key) const;
+
+    const family family_;
+    std::atomic<size_t> height_;
+
+    // These are protected by mutex.
+    rocksdb::DB* db_;
+    rocksdb::ColumnFamilyHandle* blocks_handle_;
+    rocksdb::ColumnFamilyHandle* metadata_handle_;
+    mutable system::shared_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_QUERY_POOL_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_QUERY_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// A fixed set of threads that run queries (and so wait on disk) apart from
+/// the threads of callers. Queries beyond the in-flight limit are refused,
+/// so a burst of cache misses cannot queue without bound.
+class BCD_API query_pool
+  : system::noncopyable
+{
+public:
+    typedef std::function<void()> task;
+
+    /// Start the threads.
+    query_pool(size_t threads, size_t maximum_in_flight);
+
+    /// Stop and join.
+    ~query_pool();
+
+    /// The number of queries queued or running.
+    size_t in_flight() const;
+
+    /// Queue the task, false if stopped or at the in-flight limit.
+    bool post(task&& query);
+
+    /// Refuse new tasks, run those queued and join the threads.
+    void stop();
+
+private:
+    void run();
+
+    const size_t maximum_in_flight_;
+    std::vector<std::thread> threads_;
+
+    // These are protected by mutex.
+    bool stopped_;
+    size_t running_;
+    std::queue<task> queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
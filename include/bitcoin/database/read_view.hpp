@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_READ_VIEW_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_READ_VIEW_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/reader.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/optimistic_transaction_db.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// A consistent read-only view of the store, without the cost of beginning
+/// a transaction. The snapshot is released when the view is destroyed, so
+/// results that read lazily (e.g. tx bodies) keep the view alive. The store
+/// is not closed while a view is held, so views (and the iterators and
+/// results holding them) must be released before close.
+class BCD_API read_view
+  : public reader, system::noncopyable
+{
+public:
+    /// Snapshot the store. Bulk readers should not fill the block cache, and
+    /// set readahead for iteration over large ranges (zero is adaptive).
+    read_view(std::shared_ptr<rocksdb::OptimisticTransactionDB> db,
+        bool fill_cache=true, size_t readahead=0);
+
+    /// Release the snapshot.
+    ~read_view();
+
+    rocksdb::ReadOptions read_options() const override;
+
+    rocksdb::Status get(rocksdb::ColumnFamilyHandle* handle,
+        const rocksdb::Slice& key, std::string* value) const override;
+
+    std::vector<rocksdb::Status> multi_get(
+        const std::vector<rocksdb::ColumnFamilyHandle*>& handles,
+        const std::vector<rocksdb::Slice>& keys,
+        std::vector<std::string>* values) const override;
+
+    rocksdb::Iterator* iterator(rocksdb::ColumnFamilyHandle* handle,
+        const rocksdb::ReadOptions& options) const override;
+
+private:
+    const std::shared_ptr<rocksdb::OptimisticTransactionDB> db_;
+    const rocksdb::Snapshot* snapshot_;
+    rocksdb::ReadOptions options_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_READER_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_READER_HPP
+
+#include <string>
+#include <vector>
+#include <bitcoin/database/define.hpp>
+#include "rocksdb/db.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// The reads made by queries, implemented by a transaction context (which
+/// also sees its own writes) and by a read view (a bare snapshot).
+class BCD_API reader
+{
+public:
+    virtual ~reader() {}
+
+    /// Options of reads made through this reader (including any snapshot).
+    virtual rocksdb::ReadOptions read_options() const = 0;
+
+    /// Read the value of the key.
+    virtual rocksdb::Status get(rocksdb::ColumnFamilyHandle* handle,
+        const rocksdb::Slice& key, std::string* value) const = 0;
+
+    /// Read the values of the keys, in one batch.
+    virtual std::vector<rocksdb::Status> multi_get(
+        const std::vector<rocksdb::ColumnFamilyHandle*>& handles,
+        const std::vector<rocksdb::Slice>& keys,
+        std::vector<std::string>* values) const = 0;
+
+    /// A new iterator over the family (caller owns), options are expected to
+    /// derive from read_options.
+    virtual rocksdb::Iterator* iterator(rocksdb::ColumnFamilyHandle* handle,
+        const rocksdb::ReadOptions& options) const = 0;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
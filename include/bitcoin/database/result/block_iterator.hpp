@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_BLOCK_ITERATOR_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_BLOCK_ITERATOR_HPP
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/query_pool.hpp>
+#include <bitcoin/database/read_view.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+class block_database;
+class transaction_database;
+
+/// Input iterator over the confirmed blocks of a height range, in order.
+/// Up to window blocks beyond the current are read on the query pool, and
+/// the index is read in window sized ranges. A block not yet started by the
+/// pool (or refused by it) is read by the iterating thread when needed.
+/// Iteration ends at the last height or the first block that cannot be
+/// read. The databases must outlive the iterator.
+class BCD_API block_iterator
+{
+public:
+    typedef system::chain::block value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const system::chain::block* pointer;
+    typedef const system::chain::block& reference;
+    typedef std::input_iterator_tag iterator_category;
+
+    /// Construct an end iterator.
+    block_iterator();
+
+    /// Construct an iterator positioned at the first height. Reads are made
+    /// through the view, which must be thread safe (not a transaction), on
+    /// the pool (if any).
+    block_iterator(std::shared_ptr<read_view> view,
+        const block_database& blocks,
+        const transaction_database& transactions, size_t first,
+        size_t last, size_t window, std::shared_ptr<query_pool> pool);
+
+    /// Not copyable, as background reads belong to one iterator.
+    block_iterator(block_iterator&& other) = default;
+    block_iterator& operator=(block_iterator&& other) = default;
+
+    /// Background reads not yet started are abandoned.
+    ~block_iterator();
+
+    /// True if not at the end.
+    operator bool() const;
+
+    /// The height of the current block.
+    size_t height() const;
+
+    /// Operators.
+    reference operator*() const;
+    pointer operator->() const;
+    block_iterator& operator++();
+    bool operator==(const block_iterator& other) const;
+    bool operator!=(const block_iterator& other) const;
+
+private:
+    class read;
+
+    // Read the next window of hashes from the index.
+    void read_hashes();
+
+    // Start background reads until the window is full.
+    void prefetch();
+
+    // Move to the next prefetched block.
+    void next();
+
+    std::shared_ptr<read_view> view_;
+    std::shared_ptr<query_pool> pool_;
+    const block_database* blocks_;
+    const transaction_database* transactions_;
+    size_t last_;
+    size_t window_;
+
+    // Hashes read from the index, those from the offset not yet read.
+    system::hash_list hashes_;
+    size_t hash_offset_;
+    size_t next_hash_height_;
+
+    std::deque<std::shared_ptr<read>> pending_;
+    system::chain::block current_;
+    size_t height_;
+    bool valid_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
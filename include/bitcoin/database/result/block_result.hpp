@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_BLOCK_RESULT_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_BLOCK_RESULT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/reader.hpp>
+#include "rocksdb/db.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// Stored block header and metadata. The transaction hashes of the block
+/// are only read (from the block transactions family) when requested.
+class BCD_API block_result
+{
+public:
+    /// Construct a not found result.
+    block_result();
+
+    /// Construct a found result from the stored header record.
+    block_result(std::shared_ptr<reader> context,
+        rocksdb::ColumnFamilyHandle* block_transactions_handle,
+        const system::chain::header& header, size_t height,
+        uint32_t median_time_past, uint8_t state, uint32_t checksum);
+
+    /// True if this block result is valid (found).
+    operator bool() const;
+
+    /// The block header hash (from cache).
+    system::hash_digest hash() const;
+
+    /// The block header.
+    const system::chain::header& header() const;
+
+    /// The height of this block in the chain.
+    size_t height() const;
+
+    /// The median time past of this block.
+    uint32_t median_time_past() const;
+
+    /// The block state.
+    uint8_t state() const;
+
+    /// The block validation error code (if failed).
+    system::code error() const;
+
+    /// The number of transactions in this block.
+    size_t transaction_count() const;
+
+    /// The hashes of the transactions of this block, in block order.
+    system::hash_list transaction_hashes() const;
+
+private:
+    std::shared_ptr<reader> context_;
+    rocksdb::ColumnFamilyHandle* block_transactions_handle_;
+
+    system::chain::header header_;
+    system::hash_digest hash_;
+    size_t height_;
+    uint32_t median_time_past_;
+    uint8_t state_;
+    uint32_t checksum_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_FILTER_RESULT_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_FILTER_RESULT_HPP
+
+#include <cstdint>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// Stored compact block filter (BIP158) and filter header of a block.
+class BCD_API filter_result
+{
+public:
+    /// Construct a not found result.
+    filter_result();
+
+    /// Construct a found result from the stored filter record.
+    filter_result(const system::hash_digest& block_hash,
+        const system::data_chunk& value);
+
+    /// True if this filter result is valid (found).
+    operator bool() const;
+
+    /// The hash of the filtered block.
+    const system::hash_digest& block_hash() const;
+
+    /// The filter type (basic).
+    uint8_t filter_type() const;
+
+    /// The filter header, committing to all filters of the chain.
+    const system::hash_digest& header() const;
+
+    /// The serialized filter.
+    const system::data_chunk& filter() const;
+
+private:
+    bool valid_;
+    system::hash_digest block_hash_;
+    uint8_t filter_type_;
+    system::hash_digest header_;
+    system::data_chunk filter_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_PAYMENT_ITERATOR_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_PAYMENT_ITERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/reader.hpp>
+#include <bitcoin/database/result/payment_result.hpp>
+#include "rocksdb/db.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// Forward iterator over the payments of a script hash, newest first.
+/// Iteration ends when the script hash or the limit is exhausted.
+class BCD_API payment_iterator
+{
+public:
+    typedef payment_result value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const payment_result* pointer;
+    typedef const payment_result& reference;
+    typedef std::input_iterator_tag iterator_category;
+
+    /// Construct an end iterator.
+    payment_iterator();
+
+    /// Construct an iterator positioned at the first payment to read.
+    payment_iterator(std::shared_ptr<reader> context,
+        std::shared_ptr<rocksdb::Iterator> iterator,
+        const system::hash_digest& script_hash, size_t limit);
+
+    /// True if not at the end.
+    operator bool() const;
+
+    /// Operators.
+    reference operator*() const;
+    pointer operator->() const;
+    payment_iterator& operator++();
+    bool operator==(const payment_iterator& other) const;
+    bool operator!=(const payment_iterator& other) const;
+
+private:
+    void populate();
+
+    // The reader owns the transaction or snapshot the iterator reads.
+    std::shared_ptr<reader> context_;
+    std::shared_ptr<rocksdb::Iterator> iterator_;
+    system::hash_digest script_hash_;
+    size_t remaining_;
+    payment_result current_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_PAYMENT_RESULT_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_PAYMENT_RESULT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/layouts.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// A payment (output or input) of a script hash, read from the payment
+/// index. The cursor identifies the payment for paginated history reads.
+class BCD_API payment_result
+{
+public:
+    /// This is the unconfirmed payment height sentinel.
+    static const uint32_t unconfirmed;
+
+    /// The payment index key, ordered newest first within a script hash.
+    static payment_key::record::type to_key(
+        const system::hash_digest& script_hash,
+        size_t height, size_t position, uint32_t index, bool is_output,
+        const system::hash_digest& hash);
+
+    /// Construct a not found result.
+    payment_result();
+
+    /// Construct a result from a payment index key and value.
+    payment_result(const system::data_chunk& key, uint64_t value);
+
+    /// True if this payment result is valid (found).
+    operator bool() const;
+
+    /// The hash of the paying or spending transaction.
+    const system::hash_digest& hash() const;
+
+    /// The height of the block of the tx, or unconfirmed.
+    size_t height() const;
+
+    /// The ordinal position of the tx in its block.
+    size_t position() const;
+
+    /// The output index (if output) or input index (if input).
+    uint32_t index() const;
+
+    /// True if an output (receive), false if an input (spend).
+    bool is_output() const;
+
+    /// The output value, or the value of the previous output if input.
+    uint64_t value() const;
+
+    /// The payment is confirmed.
+    bool confirmed() const;
+
+    /// The opaque position of this payment in the history.
+    const system::data_chunk& cursor() const;
+
+private:
+    system::hash_digest hash_;
+    uint32_t height_;
+    uint16_t position_;
+    uint32_t index_;
+    bool is_output_;
+    uint64_t value_;
+    system::data_chunk cursor_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
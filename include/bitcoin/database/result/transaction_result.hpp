@@ -21,8 +21,11 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <bitcoin/system.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/reader.hpp>
+#include "rocksdb/db.h"
 // TODO(kp) bring this back
 // #include <bitcoin/database/result/inpoint_iterator.hpp>
 
@@ -30,7 +33,8 @@ namespace libbitcoin {
 namespace database {
 
 /// The class uses rocksdb iterator to provide libbitcoin database
-/// iterator interface.
+/// iterator interface. Metadata is read with the result, the transaction
+/// body is only read (from the body column family) when requested.
 class BCD_API transaction_result
 {
 public:
@@ -49,7 +53,19 @@ public:
     /// This is deconfirmed tx position sentinel.
     static const uint16_t deconfirmed;
 
-    transaction_result(system::shared_mutex& metadata_mutex);
+    /// Construct a not found result.
+    transaction_result();
+
+    /// Construct a found result from stored metadata.
+    transaction_result(std::shared_ptr<reader> context,
+        rocksdb::ColumnFamilyHandle* body_handle,
+        const system::hash_digest& hash, uint32_t height, uint16_t position,
+        bool candidate, uint32_t median_time_past);
+
+    /// Construct a found result for a pooled (unconfirmed) tx, verified with
+    /// forks, from its stored body.
+    transaction_result(const system::hash_digest& hash, uint32_t forks,
+        const system::data_chunk& body);
 
     /// True if this transaction result is valid (found).
     operator bool() const;
@@ -63,6 +79,13 @@ public:
     /// The ordinal position of the tx in a block, or unconfirmed or deconfirmed.
     size_t position() const;
 
+    /// The transaction is in the pool (not in a block).
+    bool pooled() const;
+
+    /// The transaction was confirmed below the prune depth, so only its
+    /// outputs are retained (reads the body).
+    bool pruned() const;
+
     /// The transaction is in a candidate block.
     bool candidate() const;
 
@@ -78,7 +101,7 @@ public:
     /// The output at the specified index within this transaction.
     system::chain::output output(uint32_t index) const;
 
-    /// The transaction, optionally including witness.
+    /// The transaction, optionally including witness, invalid if pruned.
     system::chain::transaction transaction(bool witness=true) const;
 
     // TODO (kp) bring these back
@@ -87,14 +110,20 @@ public:
     // inpoint_iterator end() const;
 
 private:
+    system::data_chunk body() const;
+
+    // The body is read through the reader that produced the metadata.
+    std::shared_ptr<reader> context_;
+    rocksdb::ColumnFamilyHandle* body_handle_;
+
+    // A pooled tx body is read with the result.
+    system::data_chunk pooled_body_;
+
+    system::hash_digest hash_;
     bool candidate_;
     uint32_t height_;
     uint16_t position_;
     uint32_t median_time_past_;
-
-
-    // Metadata values are kept consistent by mutex.
-    system::shared_mutex& metadata_mutex_;
 };
 
 } // namespace database
@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_SETTINGS_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_SETTINGS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include "rocksdb/advanced_options.h"
+#include "rocksdb/compression_type.h"
+#include "rocksdb/options.h"
+#include "rocksdb/types.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// Common database configuration settings, properties not thread safe.
+/// Settings are applied when the store is created or opened, so a store
+/// may be reopened with another preset (e.g. once caught up after initial
+/// block download).
+class BCD_API settings
+{
+public:
+    typedef std::map<std::string, rocksdb::CompressionType> compressions;
+    typedef std::vector<rocksdb::DbPath> paths;
+    typedef std::map<std::string, paths> family_paths_map;
+
+    /// Settings tuned for a use of the store.
+    enum class preset
+    {
+        /// Balanced for a synced node.
+        standard,
+
+        /// Write throughput over read latency and durability of the last
+        /// writes, which are verified on open after an unclean shutdown.
+        initial_block_download,
+
+        /// Read throughput and compression of a full history. Indexes are
+        /// not implied, catalog and filter are set by the caller.
+        archive_server,
+
+        /// A small memory and thread footprint.
+        low_memory
+    };
+
+    settings();
+    settings(preset context);
+
+    /// Properties.
+    /// -----------------------------------------------------------------------
+
+    /// Path to the store directory.
+    boost::filesystem::path directory;
+
+    /// Maintain the payment index (catalog) and block filters.
+    bool catalog;
+    bool filter;
+
+    /// Memory.
+    /// -----------------------------------------------------------------------
+
+    /// Total memory budget, split between memtables, the shared block cache,
+    /// the unspent outputs cache and (if in memory) the pool.
+    uint64_t memory_budget;
+
+    /// Block cache capacity, which is also charged for memtables (0 for the
+    /// memory budget less the unspent outputs cache and pool).
+    uint64_t block_cache_bytes;
+
+    /// Transactions in the unspent outputs cache (0 for a share of the
+    /// memory budget).
+    size_t cache_capacity;
+
+    /// Upper bound of a single memtable, which otherwise has an even share
+    /// of the memtable budget.
+    uint64_t write_buffer_bytes;
+
+    /// Blocks for which the unspent output cache retains spent outputs, so
+    /// that it remains valid across reorganization of up to this depth.
+    size_t unspent_spent_window;
+
+    /// Compaction.
+    /// -----------------------------------------------------------------------
+
+    /// Leveled compaction bounds space and read amplification, universal
+    /// compaction bounds write amplification (FIFO drops data, do not use).
+    rocksdb::CompactionStyle compaction_style;
+
+    /// Threads shared by flushes and compactions.
+    int max_background_jobs;
+
+    /// Compaction debt (bytes pending compaction) above which backpressure
+    /// is signaled, below the rocksdb soft limit (64GiB) at which writes are
+    /// delayed (0 signals only rocksdb write stalls).
+    uint64_t compaction_debt_limit;
+
+    /// Block confirmation waits out backpressure (up to throttle_timeout),
+    /// trading peak write rate for fewer rocksdb write stalls.
+    bool throttle_writes;
+
+    /// Longest wait of a throttled write, in milliseconds.
+    uint32_t throttle_timeout;
+
+    /// Compression.
+    /// -----------------------------------------------------------------------
+
+    /// Upper level compression of all families but those stored raw.
+    rocksdb::CompressionType compression;
+
+    /// Upper level compression by family name, overriding the above (and
+    /// the transaction dictionary) but not the families stored raw.
+    compressions family_compression;
+
+    /// Zstd dictionary size for transaction data (0 disables dictionaries).
+    uint32_t compression_dictionary_bytes;
+
+    /// Bottommost level compression, configured apart from upper levels.
+    rocksdb::CompressionType bottommost_compression;
+    int bottommost_compression_level;
+    uint32_t bottommost_dictionary_bytes;
+
+    /// Transaction bodies of at least this size are stored in blob files.
+    uint64_t blob_threshold;
+
+    /// Blob garbage collection policy: the oldest fraction of blob files is
+    /// relocated during compaction (0 disables blob garbage collection).
+    double blob_garbage_collection_age_cutoff;
+
+    /// Force compaction of the oldest blob files at this garbage ratio.
+    double blob_garbage_collection_force_threshold;
+
+    /// Durability.
+    /// -----------------------------------------------------------------------
+
+    /// Sync the write ahead log on each commit.
+    bool sync_writes;
+
+    /// Commit without the write ahead log, so that writes since the last
+    /// flush are lost on an unclean shutdown (and the store recovered).
+    bool disable_wal;
+
+    /// Write ahead log size that forces a flush (0 for the rocksdb default).
+    uint64_t max_total_wal_bytes;
+
+    /// Bypass the page cache for reads and for flushes and compactions, so
+    /// that the page cache doesn't duplicate the block cache and bulk scans
+    /// (which do not fill the block cache) don't evict the page cache.
+    bool direct_reads;
+    bool direct_writes;
+
+    /// Number of most recent backups retained by backup.
+    uint32_t backups_retained;
+
+    /// Most recent blocks of each index verified on open after an unclean
+    /// shutdown (0 trusts the store without verification).
+    size_t verify_depth;
+
+    /// Threads verifying blocks on open after an unclean shutdown.
+    size_t verify_threads;
+
+    /// Tiers.
+    /// -----------------------------------------------------------------------
+    /// Backup (and so restore) is not supported for a tiered store.
+
+    /// Table file paths with target sizes, fastest first. Each path is filled
+    /// to its target before the next is used, so that the upper levels
+    /// (recent data) are on the first path. Empty for the store directory.
+    paths data_paths;
+
+    /// Table file paths by family name, overriding data_paths (e.g. to keep
+    /// the blocks, block_state, block_index and transaction_metadata
+    /// families on fast storage while transactions are on slow storage).
+    family_paths_map family_paths;
+
+    /// Temperature of last level files, placed by a file system that
+    /// supports temperatures (unknown for no placement).
+    rocksdb::Temperature last_level_temperature;
+
+    /// Writes are kept from the last level for this many seconds, so that
+    /// recent data is not placed with cold history (0 for no hot data).
+    uint64_t hot_data_seconds;
+
+    /// Pruning.
+    /// -----------------------------------------------------------------------
+
+    /// Confirmed blocks deeper than this (and verify_depth) are pruned by
+    /// compaction: tx bodies are reduced to their outputs and block tx
+    /// records are dropped, so pruned blocks cannot be served, indexed or
+    /// reorganized (0 retains all blocks).
+    size_t prune_depth;
+
+    /// Also drop the block filters of pruned blocks.
+    bool prune_filters;
+
+    /// Pool.
+    /// -----------------------------------------------------------------------
+
+    /// Unconfirmed transactions expire from the pool after this many seconds.
+    uint32_t pool_expiry;
+
+    /// Keep unconfirmed transactions only in memory (lost on close).
+    bool memory_pool;
+
+    /// Bytes of the in-memory pool, beyond which the oldest transactions
+    /// are evicted (0 for a share of the memory budget).
+    uint64_t memory_pool_bytes;
+
+    /// Queries.
+    /// -----------------------------------------------------------------------
+
+    /// Blocks read ahead of the consumer by a block range read.
+    size_t block_prefetch_window;
+
+    /// Readahead of bulk scans (block range reads and full family scans),
+    /// zero for automatic readahead, which grows with sequential reads.
+    size_t scan_readahead;
+
+    /// Threads running asynchronous queries.
+    size_t query_threads;
+
+    /// Asynchronous queries queued or running, beyond which they are refused.
+    size_t query_max_in_flight;
+
+    /// Threads reading the previous outputs of received blocks.
+    size_t prefetch_threads;
+
+    /// Received blocks queued or being prefetched, beyond which the
+    /// previous outputs of further blocks are read by validation.
+    size_t prefetch_max_blocks;
+
+    /// Blocks per sorted table file written by the deferred catalog build.
+    size_t catalog_chunk_blocks;
+
+    /// Stats.
+    /// -----------------------------------------------------------------------
+
+    /// Sample rocksdb perf and io stats of one in this many calls of each
+    /// sampled operation (0 disables sampling).
+    size_t perf_sample_rate;
+
+    /// Seconds between logs of sampled stats (0 disables logging).
+    uint32_t perf_log_interval;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_SLICE_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_SLICE_HPP
+
+#include <string>
+#include <bitcoin/system.hpp>
+#include "rocksdb/slice.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// Reference a byte container as a rocksdb slice (no copy).
+template <typename Container>
+rocksdb::Slice to_slice(const Container& bytes)
+{
+    return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+}
+
+/// Copy a rocksdb value into a data chunk.
+inline system::data_chunk to_chunk(const std::string& value)
+{
+    return { value.begin(), value.end() };
+}
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -19,6 +19,10 @@
 #ifndef LIBBITCOIN_ROCKSDB_DATABASE_ROCKSDB_TXN_CONTEXT_HPP
 #define LIBBITCOIN_ROCKSDB_DATABASE_ROCKSDB_TXN_CONTEXT_HPP
 
+#include <memory>
+#include <string>
+#include <vector>
+#include <bitcoin/database/reader.hpp>
 #include "rocksdb/db.h"
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
@@ -27,16 +31,31 @@ namespace libbitcoin {
 namespace database {
 
 /// Requires explicit begin and commit to allow use across blocks that
-/// don't allow RAII
+/// don't allow RAII. Reads see the writes of the transaction and, if begun
+/// with a snapshot, are otherwise as of the snapshot.
 class transaction_context
+  : public reader
 {
 public:
-    transaction_context(std::shared_ptr<rocksdb::OptimisticTransactionDB> db);
+    transaction_context(std::shared_ptr<rocksdb::OptimisticTransactionDB> db,
+        const rocksdb::WriteOptions& write_options={});
     void begin(const bool use_snapshot = false);
     bool commit();
     std::shared_ptr<rocksdb::Transaction> txn() const;
+
+    rocksdb::ReadOptions read_options() const override;
+    rocksdb::Status get(rocksdb::ColumnFamilyHandle* handle,
+        const rocksdb::Slice& key, std::string* value) const override;
+    std::vector<rocksdb::Status> multi_get(
+        const std::vector<rocksdb::ColumnFamilyHandle*>& handles,
+        const std::vector<rocksdb::Slice>& keys,
+        std::vector<std::string>* values) const override;
+    rocksdb::Iterator* iterator(rocksdb::ColumnFamilyHandle* handle,
+        const rocksdb::ReadOptions& options) const override;
+
 private:
     std::shared_ptr<rocksdb::OptimisticTransactionDB> db_;
+    const rocksdb::WriteOptions write_options_;
     std::shared_ptr<rocksdb::Transaction> txn_;
 };
 
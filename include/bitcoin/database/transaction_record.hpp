@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_TRANSACTION_RECORD_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_TRANSACTION_RECORD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// Stored transaction body encoding.
+/// Standard output scripts are stored as a one byte template tag and its
+/// payload and amounts as compressed varints. Decoding reproduces the
+/// original transaction byte for byte.
+class BCD_API transaction_record
+{
+public:
+    /// Output script templates, stored as the first byte of each script.
+    enum script_template : uint8_t
+    {
+        /// Any other script, followed by varint size and script bytes.
+        raw = 0,
+
+        /// Followed by the 20 byte hash.
+        pay_key_hash = 1,
+        pay_script_hash = 2,
+        pay_witness_key_hash = 3,
+
+        /// Followed by the 32 byte hash or key.
+        pay_witness_script_hash = 4,
+        pay_taproot = 5,
+
+        /// Followed by the 33 or 65 byte public key.
+        pay_compressed_key = 6,
+        pay_uncompressed_key = 7
+    };
+
+    /// Serialize the transaction (with witness) in the stored format.
+    static system::data_chunk to_data(const system::chain::transaction& tx);
+
+    /// Deserialize a stored transaction, invalid if the record is invalid.
+    static system::chain::transaction factory(const system::data_chunk& data,
+        bool witness=true);
+
+    /// Reduce a stored transaction to its outputs (with version and locktime),
+    /// empty if the record is invalid. A pruned record has no inputs.
+    static system::data_chunk to_pruned(const system::data_chunk& data);
+
+    /// The stored transaction is pruned (has no inputs).
+    static bool is_pruned(const system::data_chunk& data);
+
+    /// Amount compression (trailing decimal zeros folded into the exponent).
+    static uint64_t compress_amount(uint64_t value);
+    static uint64_t expand_amount(uint64_t value);
+
+    /// Script template compression (scripts are unprefixed bytes).
+    static system::data_chunk compress_script(
+        const system::data_chunk& script);
+    static system::data_chunk expand_script(system::reader& source);
+
+    /// Base 128 varint, one byte for values below 128.
+    static void write_varint(system::writer& sink, uint64_t value);
+    static uint64_t read_varint(system::reader& source);
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -22,6 +22,8 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <utility>
 #include <boost/bimap.hpp>
 #include <boost/bimap/set_of.hpp>
 #include <boost/bimap/unordered_set_of.hpp>
@@ -33,13 +35,17 @@ namespace libbitcoin {
 namespace database {
 
 /// This class is thread safe.
-/// A circular-by-age hash table of [point, output].
+/// A circular-by-age hash table of [point, output]. Confirmed spent outputs
+/// are retained with their spender height until that height leaves the
+/// spent window, so the cache answers for any fork point within the window
+/// and survives reorganization of the blocks within it.
 class BCD_API unspent_outputs
   : system::noncopyable
 {
 public:
-    // Construct a cache with the specified transaction count limit.
-    unspent_outputs(size_t capacity);
+    // Construct a cache with the specified transaction count limit, which
+    // retains spent outputs for spent_window blocks.
+    unspent_outputs(size_t capacity, size_t spent_window=0);
 
     /// The cache capacity is zero.
     bool disabled() const;
@@ -53,35 +59,74 @@ public:
     /// The cache performance as a ratio of hits to accesses.
     float hit_rate() const;
 
-    /// Add outputs to cache, unconfirmed height is forks (purges matching tx).
+    /// Add outputs to cache, unconfirmed height is forks. A cached tx is
+    /// promoted in place (a confirmed tx is not demoted).
     void add(const system::chain::transaction& tx, size_t height,
         uint32_t median_time_past, bool confirmed);
 
+    /// Add or promote the outputs of all txs of the confirmed block.
+    void add(const system::chain::block& block, size_t height,
+        uint32_t median_time_past);
+
+    /// Add the outputs of the entry (e.g. prefetched), unless the tx is
+    /// already cached, in which case the cached outputs are retained.
+    void add(unspent_transaction&& unspent);
+
     /// Remove outputs from the cache (tx has been reorganized out).
     void remove(const system::hash_digest& tx_hash);
 
     /// Remove one output from the cache (has been confirmed spent).
     void remove(const system::chain::output_point& point);
 
+    /// Mark the output confirmed spent at the height, and remove outputs
+    /// spent below the spent window (immediately if the window is zero).
+    void spend(const system::chain::output_point& point,
+        size_t spender_height);
+
+    /// Roll back the confirmation of the tx (reorganized out): its outputs
+    /// become unconfirmed and the outputs it spent become unspent.
+    void unconfirm(const system::chain::transaction& tx);
+
+    /// Add or promote the outputs of all txs of the block and mark the
+    /// outputs spent by them, under one lock (as add(block) and spend).
+    void apply(const system::chain::block& block, size_t height,
+        uint32_t median_time_past);
+
+    /// Roll back the confirmation of all txs of the block, under one lock
+    /// (as unconfirm of each tx).
+    void revert(const system::chain::block& block);
+
     /// Populate output if cached/unspent relative to fork height.
     bool populate(const system::chain::output_point& point,
         size_t fork_height=max_size_t) const;
 
 private:
+    void store(const system::chain::transaction& tx, size_t height,
+        uint32_t median_time_past, bool confirmed);
+    void spend_output(const system::chain::output_point& point,
+        size_t spender_height);
+    void prune(size_t spender_height);
+    void demote(const system::chain::transaction& tx);
+
     // A bidirection map is used for efficient output and position retrieval.
     // This produces the effect of a circular buffer tx hash table of outputs.
     typedef boost::bimaps::bimap<
         boost::bimaps::unordered_set_of<unspent_transaction>,
         boost::bimaps::set_of<uint32_t>> unspent_transactions;
 
+    typedef std::deque<std::pair<size_t, system::chain::output_point>>
+        spent_outputs;
+
     // These are thread safe.
     const size_t capacity_;
+    const size_t spent_window_;
     mutable std::atomic<size_t> hits_;
     mutable std::atomic<size_t> queries_;
 
     // These are protected by mutex.
     uint32_t sequence_;
     unspent_transactions unspent_;
+    spent_outputs spent_;
     mutable system::upgrade_mutex mutex_;
 };
 
@@ -37,6 +37,10 @@ public:
     typedef std::unordered_map<uint32_t, system::chain::output> output_map;
     typedef std::shared_ptr<output_map> output_map_ptr;
 
+    /// Confirmed spender heights of outputs, by output index.
+    typedef std::unordered_map<uint32_t, size_t> spender_map;
+    typedef std::shared_ptr<spender_map> spender_map_ptr;
+
     // Move/copy constructors.
     unspent_transaction(unspent_transaction&& other);
     unspent_transaction(const unspent_transaction& other);
@@ -47,6 +51,10 @@ public:
     explicit unspent_transaction(const system::chain::transaction& tx,
         size_t height, uint32_t median_time_past, bool confirmed);
 
+    /// Construct without outputs, for populating a subset of the outputs.
+    unspent_transaction(const system::hash_digest& hash, size_t height,
+        uint32_t median_time_past, bool coinbase, bool confirmed);
+
     /// Properties.
     size_t height() const;
     uint32_t median_time_past() const;
@@ -57,6 +65,13 @@ public:
     /// Access to outputs is mutable and unprotected (not thread safe).
     output_map_ptr outputs() const;
 
+    /// Access to spenders is mutable and unprotected (not thread safe).
+    spender_map_ptr spenders() const;
+
+    /// A copy with the confirmation state replaced, sharing outputs.
+    unspent_transaction reconfirm(size_t height, uint32_t median_time_past,
+        bool confirmed) const;
+
     /// Operators.
     bool operator==(const unspent_transaction& other) const;
     unspent_transaction& operator=(unspent_transaction&& other);
@@ -74,6 +89,7 @@ private:
     // This is not thread safe and is publicly reachable.
     // The outputs can be changed without affecting the bimapping.
     mutable output_map_ptr outputs_;
+    mutable spender_map_ptr spenders_;
 };
 
 } // namespace database
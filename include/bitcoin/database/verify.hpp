@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_VERIFY_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_VERIFY_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/read_view.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+class block_database;
+class transaction_database;
+
+/// Verify the candidate|confirmed index entry at the height against the
+/// block and transaction records it references. Returns not_found if the
+/// index has no entry at the height, store_block_missing_parent if the
+/// block is missing or does not link to the entry below it,
+/// store_block_invalid_height if the block is stored at another height, or
+/// store_incorrect_state if the block state or the confirmation of its txs
+/// (confirmed index only) disagree with the index (repairable).
+BCD_API system::code verify(std::shared_ptr<reader> context,
+    const block_database& blocks, const transaction_database& transactions,
+    size_t height, bool candidate);
+
+/// Verify the index entries from first through last height, in parallel
+/// over the given number of threads, reading through the view. Returns the
+/// result of each height, in order.
+BCD_API std::vector<system::code> verify(std::shared_ptr<read_view> view,
+    const block_database& blocks, const transaction_database& transactions,
+    size_t first, size_t last, bool candidate, size_t threads);
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
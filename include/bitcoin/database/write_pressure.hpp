@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_ROCKSDB_DATABASE_WRITE_PRESSURE_HPP
+#define LIBBITCOIN_ROCKSDB_DATABASE_WRITE_PRESSURE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/listener.h"
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// Tracks rocksdb write stall conditions, flushes, compactions and the
+/// compaction debt (estimated bytes pending compaction) of the store, so
+/// that writers can back off before rocksdb delays or stops writes.
+class BCD_API write_pressure
+  : public rocksdb::EventListener
+{
+public:
+    /// The write condition, worst of all column families.
+    enum stall : uint8_t
+    {
+        normal,
+        delayed,
+        stopped
+    };
+
+    /// Counters since construction.
+    struct counters
+    {
+        uint64_t delays;
+        uint64_t stops;
+        uint64_t stall_nanoseconds;
+        uint64_t flushes;
+        uint64_t compactions;
+        size_t active_flushes;
+        size_t active_compactions;
+        uint64_t compaction_debt;
+    };
+
+    write_pressure();
+
+    /// The current write condition.
+    stall condition() const;
+
+    /// Writes are delayed or stopped, or the compaction debt exceeds the
+    /// threshold (zero disables the debt threshold).
+    bool backpressure(uint64_t debt_threshold) const;
+
+    /// The counters.
+    counters get() const;
+
+    /// Wait until writes are not stopped and the compaction debt is within
+    /// the threshold, false if timed out.
+    bool wait(uint64_t debt_threshold,
+        std::chrono::milliseconds timeout) const;
+
+    // rocksdb::EventListener (called on rocksdb threads).
+    void OnFlushBegin(rocksdb::DB* db,
+        const rocksdb::FlushJobInfo& info) override;
+    void OnFlushCompleted(rocksdb::DB* db,
+        const rocksdb::FlushJobInfo& info) override;
+    void OnCompactionBegin(rocksdb::DB* db,
+        const rocksdb::CompactionJobInfo& info) override;
+    void OnCompactionCompleted(rocksdb::DB* db,
+        const rocksdb::CompactionJobInfo& info) override;
+    void OnStallConditionsChanged(
+        const rocksdb::WriteStallInfo& info) override;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    stall worst() const;
+    bool relieved(uint64_t debt_threshold) const;
+    static bool read_debt(rocksdb::DB* db, uint64_t& out_debt);
+
+    // These are protected by mutex.
+    counters counters_;
+    std::unordered_map<std::string, stall> conditions_;
+    clock::time_point stalled_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable condition_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
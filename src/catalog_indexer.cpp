@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/catalog_indexer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/read_view.hpp>
+#include <bitcoin/database/slice.hpp>
+#include <bitcoin/database/databases/payment_database.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/sst_file_writer.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+catalog_indexer::catalog_indexer(
+    std::shared_ptr<rocksdb::OptimisticTransactionDB> db,
+    const block_database& blocks, const transaction_database& transactions,
+    rocksdb::ColumnFamilyHandle* payments_handle,
+    const boost::filesystem::path& directory, size_t threads,
+    size_t chunk_blocks)
+  : db_(db),
+    blocks_(blocks),
+    transactions_(transactions),
+    payments_handle_(payments_handle),
+    directory_(directory),
+    threads_(std::max(threads, size_t(1))),
+    chunk_blocks_(std::max(chunk_blocks, size_t(1))),
+    stopped_(false)
+{
+}
+
+void catalog_indexer::stop()
+{
+    stopped_ = true;
+}
+
+bool catalog_indexer::stopped() const
+{
+    return stopped_;
+}
+
+// Chunks are claimed in height order by each thread and completed in any
+// order, progress is reported through the lowest incomplete chunk.
+bool catalog_indexer::index(size_t first, size_t last, progress_handler handler)
+{
+    if (first > last)
+        return true;
+
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(directory_, ec);
+    if (ec)
+        return false;
+
+    const auto chunks = (last - first) / chunk_blocks_ + 1;
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+
+    std::mutex mutex;
+    std::vector<bool> completed(chunks, false);
+    size_t pending = 0;
+
+    const auto work = [&]()
+    {
+        for (auto chunk = next++; chunk < chunks && !failed; chunk = next++)
+        {
+            const auto start = first + chunk * chunk_blocks_;
+            const auto stop = std::min(start + chunk_blocks_ - 1, last);
+
+            if (!index_chunk(start, stop))
+            {
+                failed = true;
+                return;
+            }
+
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            std::lock_guard<std::mutex> lock(mutex);
+            completed[chunk] = true;
+
+            const auto previous = pending;
+            while (pending < chunks && completed[pending])
+                ++pending;
+
+            if (pending != previous && handler)
+                handler(std::min(first + pending * chunk_blocks_ - 1, last),
+                    last);
+            ///////////////////////////////////////////////////////////////////
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < std::min(threads_, chunks); ++thread)
+        threads.emplace_back(work);
+
+    for (auto& thread: threads)
+        thread.join();
+
+    return !failed && !stopped_;
+}
+
+// private
+// A table not ingested is removed, so is not left with the store.
+void catalog_indexer::remove(const std::string& file)
+{
+    boost::system::error_code ec;
+    boost::filesystem::remove(file, ec);
+}
+
+// private
+bool catalog_indexer::index_chunk(size_t first, size_t last)
+{
+    // Read through a snapshot so the chunk is consistent with itself, a bulk
+    // read of history that should not evict the working set from the cache.
+    const auto context = std::make_shared<read_view>(db_, false);
+
+    payment_database::rows rows;
+
+    for (auto height = first; height <= last; ++height)
+    {
+        if (stopped_)
+            return false;
+
+        const auto result = blocks_.get(context, height, false);
+        if (!result)
+            return false;
+
+        const auto txs = transactions_.get(context,
+            result.transaction_hashes());
+        if (txs.empty())
+            return false;
+
+        for (size_t position = 0; position < txs.size(); ++position)
+        {
+            const auto& tx = txs[position];
+            transactions_.get_prevouts(context, tx, max_size_t);
+
+            auto payments = payment_database::to_rows(tx, height, position);
+            std::move(payments.begin(), payments.end(),
+                std::back_inserter(rows));
+        }
+    }
+
+    // Table files require ascending unique keys (bytewise comparator).
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end(),
+        [](const payment_database::rows::value_type& left,
+            const payment_database::rows::value_type& right)
+        {
+            return left.first == right.first;
+        }), rows.end());
+
+    if (rows.empty())
+        return true;
+
+    const auto file = (directory_ / ("catalog_" + std::to_string(first) +
+        ".sst")).string();
+
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(),
+        db_->GetOptions(payments_handle_), payments_handle_);
+
+    auto status = writer.Open(file);
+    for (const auto& row: rows)
+    {
+        if (!status.ok())
+            break;
+
+        status = writer.Put(to_slice(row.first),
+            to_slice(payment_database::to_value(row.second)));
+    }
+
+    if (status.ok())
+        status = writer.Finish();
+
+    if (!status.ok())
+    {
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to write catalog table: " << status.ToString();
+        remove(file);
+        return false;
+    }
+
+    rocksdb::IngestExternalFileOptions options;
+    options.move_files = true;
+    status = db_->IngestExternalFile(payments_handle_, { file }, options);
+
+    if (!status.ok())
+    {
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to ingest catalog table: " << status.ToString();
+        remove(file);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace database
+} // namespace libbitcoin
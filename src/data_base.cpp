@@ -17,7 +17,26 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <bitcoin/database/data_base.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <bitcoin/database/codec.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include <bitcoin/database/pool_expiry_filter.hpp>
+#include <bitcoin/database/slice.hpp>
+#include <bitcoin/database/verify.hpp>
+#include "rocksdb/cache.h"
 #include "rocksdb/db.h"
+#include "rocksdb/filter_policy.h"
+#include "rocksdb/slice_transform.h"
+#include "rocksdb/table.h"
+#include "rocksdb/write_buffer_manager.h"
+#include "rocksdb/utilities/backup_engine.h"
+#include "rocksdb/utilities/checkpoint.h"
 
 namespace libbitcoin {
 namespace database {
@@ -26,103 +45,774 @@ using namespace bc::system;
 using namespace bc::system::chain;
 using namespace bc::system::machine;
 
+// The memory budget is split between memtables, the block cache (which is
+// also charged for memtables by the write buffer manager), the unspent
+// outputs cache and the pool, if in memory. The block cache capacity
+// therefore includes the memtables.
+static constexpr uint64_t memtable_share = 4;
+static constexpr uint64_t unspent_share = 4;
+static constexpr uint64_t pool_share = 8;
+
+// Bytes of the in-memory pool, none if the pool is persisted. The pool is
+// limited to what the unspent outputs cache leaves of the budget.
+static uint64_t pool_bytes(const settings& config)
+{
+    if (!config.memory_pool)
+        return 0;
+
+    const auto budget = config.memory_budget;
+    const auto limit = budget - budget / unspent_share;
+    return std::min(config.memory_pool_bytes != 0 ?
+        config.memory_pool_bytes : budget / pool_share, limit);
+}
+
+// Approximate heap size of a cached unspent transaction with its outputs.
+static constexpr uint64_t unspent_transaction_size = 512;
+
+// Target size of transaction body blob files.
+static constexpr uint64_t blob_file_size = 256 * 1024 * 1024;
+
+// Bloom filter bits per key, about a 1% false positive rate.
+static constexpr double bloom_filter_bits = 10;
+
+// Zstd trains each dictionary from a sample this many times its size.
+static constexpr uint32_t dictionary_training_ratio = 100;
+
+// Filters built by index_filters are committed in transactions of this many
+// blocks.
+static constexpr size_t filter_commit_blocks = 1000;
+
+// Dictionaries are trained per SST file, from a sample of the file's data.
+static void set_dictionary(rocksdb::CompressionOptions& options,
+    uint32_t dictionary_bytes)
+{
+    options.enabled = true;
+    options.max_dict_bytes = dictionary_bytes;
+    options.zstd_max_train_bytes = dictionary_bytes *
+        dictionary_training_ratio;
+
+    // Bound the memory used to buffer the training sample.
+    options.max_dict_buffer_bytes = options.zstd_max_train_bytes;
+}
+
+// Default settings with the given directory and indexes.
+static settings make_settings(const boost::filesystem::path& directory,
+    bool catalog, bool filter)
+{
+    settings value;
+    value.directory = directory;
+    value.catalog = catalog;
+    value.filter = filter;
+    return value;
+}
+
 data_base::data_base(const path& directory, bool catalog, bool filter)
-  : closed_(true), directory_(directory), catalog_(catalog), filter_(filter)
+  : data_base(make_settings(directory, catalog, filter))
 {
 }
 
+data_base::data_base(const settings& settings)
+  : settings_(settings), closed_(true), directory_(settings.directory),
+    catalog_(settings.catalog), filter_(settings.filter),
+    catalog_live_(false), indexer_threads_(0), indexing_(false),
+    filtering_(false), filters_stopped_(false), filter_gap_(false),
+    stats_(settings.perf_sample_rate, settings.perf_log_interval),
+    pressure_(std::make_shared<write_pressure>()), consistent_(false)
+{
+    const auto budget = settings_.memory_budget;
+    const auto unspent_budget = budget / unspent_share;
+    const auto memtable_budget = budget / memtable_share;
+    const auto pool_budget = pool_bytes(settings_);
+    const auto cache_bytes = settings_.block_cache_bytes == 0 ?
+        budget - unspent_budget - pool_budget : settings_.block_cache_bytes;
+
+    block_cache_ = rocksdb::NewLRUCache(cache_bytes);
+    write_buffer_manager_ = std::make_shared<rocksdb::WriteBufferManager>(
+        memtable_budget, block_cache_);
+    pool_expiry_.reset(new pool_expiry_filter(settings_.pool_expiry));
+
+    if (settings_.prune_depth == 0)
+        return;
+
+    prune_transactions_ = std::make_shared<prune_filter>(
+        prune_filter::family::transactions);
+    prune_block_transactions_ = std::make_shared<prune_filter>(
+        prune_filter::family::block_transactions);
+
+    if (settings_.prune_filters)
+        prune_filters_ = std::make_shared<prune_filter>(
+            prune_filter::family::filters);
+}
+
 data_base::~data_base()
 {
-    close();
+    // Builds resumed or left by a refused close must not outlive this.
+    if (!close())
+    {
+        stop_catalog();
+        stop_filters();
+    }
+}
+
+// Options.
+// ----------------------------------------------------------------------------
+// private
+
+rocksdb::Options
+data_base::database_options() const
+{
+    rocksdb::Options options;
+
+    // keep all column families consistent.
+    options.atomic_flush = true;
+
+    // Families added since the store was created are created empty.
+    options.create_missing_column_families = true;
+
+    // All memtables draw from a single budget charged to the block cache.
+    options.write_buffer_manager = write_buffer_manager_;
+    options.max_background_jobs = settings_.max_background_jobs;
+
+    if (settings_.max_total_wal_bytes > 0)
+        options.max_total_wal_size = settings_.max_total_wal_bytes;
+
+    // Direct reads rely on the block cache alone, so readahead of range
+    // reads is done by rocksdb rather than the page cache.
+    options.use_direct_reads = settings_.direct_reads;
+    options.use_direct_io_for_flush_and_compaction = settings_.direct_writes;
+
+    // Table files fill each tier to its target size, fastest first.
+    options.db_paths = settings_.data_paths;
+
+    // Stalls and compaction debt are observed to signal backpressure.
+    options.listeners.push_back(pressure_);
+    return options;
+}
+
+rocksdb::ColumnFamilyOptions
+data_base::column_family_options(const std::string& name,
+    size_t families) const
+{
+    rocksdb::BlockBasedTableOptions table_options;
+    table_options.block_cache = block_cache_;
+
+    // Index and filter blocks are otherwise allocated outside of the budget.
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+
+    rocksdb::ColumnFamilyOptions options;
+
+    // Payments are only read by script hash prefix seek.
+    if (name == PAYMENTS_COLUMN_FAMILY)
+    {
+        options.prefix_extractor.reset(
+            rocksdb::NewFixedPrefixTransform(hash_size));
+        table_options.filter_policy.reset(
+            rocksdb::NewBloomFilterPolicy(bloom_filter_bits));
+        table_options.whole_key_filtering = false;
+    }
+
+    // Pool lookups precede each block tx write and are mostly misses.
+    if (name == POOL_COLUMN_FAMILY)
+    {
+        options.compaction_filter = pool_expiry_.get();
+        table_options.filter_policy.reset(
+            rocksdb::NewBloomFilterPolicy(bloom_filter_bits));
+    }
+
+    // Block state is small and rewritten on each reorganization, so it is
+    // kept apart from (immutable) headers and read with each header.
+    if (name == BLOCK_STATE_COLUMN_FAMILY)
+        table_options.filter_policy.reset(
+            rocksdb::NewBloomFilterPolicy(bloom_filter_bits));
+
+    // Records of pruned blocks are pruned as they are compacted.
+    if (name == TRANSACTIONS_COLUMN_FAMILY)
+        options.compaction_filter_factory = prune_transactions_;
+
+    if (name == BLOCK_TRANSACTIONS_COLUMN_FAMILY)
+        options.compaction_filter_factory = prune_block_transactions_;
+
+    if (name == FILTERS_COLUMN_FAMILY)
+        options.compaction_filter_factory = prune_filters_;
+
+    options.table_factory.reset(
+        rocksdb::NewBlockBasedTableFactory(table_options));
+
+    // Spread the memtable budget so a single family cannot consume it all.
+    const auto share = settings_.memory_budget / memtable_share / families;
+    options.write_buffer_size = std::min(share, settings_.write_buffer_bytes);
+    options.compaction_style = settings_.compaction_style;
+
+    // A family may be placed apart from the tiers (e.g. on fast storage).
+    const auto paths = settings_.family_paths.find(name);
+    if (paths != settings_.family_paths.end())
+        options.cf_paths = paths->second;
+
+    // Recent writes are kept from the (cold) last level.
+    options.last_level_temperature = settings_.last_level_temperature;
+    options.preclude_last_level_data_seconds = settings_.hot_data_seconds;
+
+    // Separate large bodies from the LSM so compaction does not rewrite them.
+    // Metadata is in its own family, so metadata reads never touch blobs.
+    if (name == TRANSACTIONS_COLUMN_FAMILY)
+    {
+        options.enable_blob_files = true;
+        options.min_blob_size = settings_.blob_threshold;
+        options.blob_file_size = blob_file_size;
+        options.enable_blob_garbage_collection =
+            settings_.blob_garbage_collection_age_cutoff > 0.0;
+        options.blob_garbage_collection_age_cutoff =
+            settings_.blob_garbage_collection_age_cutoff;
+        options.blob_garbage_collection_force_threshold =
+            settings_.blob_garbage_collection_force_threshold;
+
+        // Blob files are compressed per record, without a dictionary.
+        options.blob_compression_type = rocksdb::kZSTD;
+    }
+
+    // Hashes and filters do not compress, so these families are stored raw.
+    if (name == BLOCK_TRANSACTIONS_COLUMN_FAMILY ||
+        name == FILTERS_COLUMN_FAMILY)
+    {
+        options.compression = rocksdb::kNoCompression;
+        options.bottommost_compression = rocksdb::kNoCompression;
+        return options;
+    }
+
+    // Most data is in the bottommost level, so it is compressed harder.
+    options.compression = settings_.compression;
+    options.bottommost_compression = settings_.bottommost_compression;
+    options.bottommost_compression_opts.enabled = true;
+    options.bottommost_compression_opts.level =
+        settings_.bottommost_compression_level;
+
+    // Transactions repeat standard script templates across records, which a
+    // shared zstd dictionary captures where block-by-block compression can't.
+    // Each level's dictionary is independent, so that the bottommost level
+    // can train one while upper levels (rewritten often) do not.
+    if (name == TRANSACTIONS_COLUMN_FAMILY &&
+        settings_.compression_dictionary_bytes > 0)
+    {
+        options.compression = rocksdb::kZSTD;
+        set_dictionary(options.compression_opts,
+            settings_.compression_dictionary_bytes);
+    }
+
+    if (name == TRANSACTIONS_COLUMN_FAMILY &&
+        settings_.bottommost_compression == rocksdb::kZSTD &&
+        settings_.bottommost_dictionary_bytes > 0)
+        set_dictionary(options.bottommost_compression_opts,
+            settings_.bottommost_dictionary_bytes);
+
+    const auto compression = settings_.family_compression.find(name);
+    if (compression != settings_.family_compression.end())
+        options.compression = compression->second;
+
+    return options;
+}
+
+std::vector<rocksdb::ColumnFamilyDescriptor>
+data_base::column_families() const
+{
+    const std::vector<std::string> names
+    {
+        rocksdb::kDefaultColumnFamilyName,
+        TRANSACTIONS_COLUMN_FAMILY,
+        BLOCKS_COLUMN_FAMILY,
+        BLOCK_STATE_COLUMN_FAMILY,
+        BLOCK_TRANSACTIONS_COLUMN_FAMILY,
+        TRANSACTION_METADATA_COLUMN_FAMILY,
+        BLOCK_INDEX_COLUMN_FAMILY,
+        PAYMENTS_COLUMN_FAMILY,
+        FILTERS_COLUMN_FAMILY,
+        POOL_COLUMN_FAMILY
+    };
+
+    std::vector<rocksdb::ColumnFamilyDescriptor> families;
+    for (const auto& name: names)
+        families.emplace_back(name, column_family_options(name,
+            names.size()));
+
+    return families;
 }
 
+// Open and close.
+// ----------------------------------------------------------------------------
+
 bool
 data_base::create(const system::chain::block& genesis)
 {
-    rocksdb::Options options;
+    auto options = database_options();
     options.create_if_missing = true;
     options.error_if_exists = true;
-    // keep all column families consistent.
-    options.atomic_flush = true;
-    rocksdb::Status status = rocksdb::OptimisticTransactionDB::Open(options, directory_.string(), &dbp_);
-    BITCOIN_ASSERT_MSG(status.ok(), "Failed to open optimistic transactions database");
-    db_ = std::shared_ptr<rocksdb::OptimisticTransactionDB>(dbp_);
 
-    rocksdb::ColumnFamilyHandle *transactions_cf, *blocks_cf;
-    status = dbp_->CreateColumnFamily(rocksdb::ColumnFamilyOptions(),
-        TRANSACTIONS_COLUMN_FAMILY, &transactions_cf);
-    BITCOIN_ASSERT_MSG(status.ok(), "Failed to create transactions column family");
-    column_family_handles_.push_back(transactions_cf);
+    if (!open(options))
+        return false;
 
-    status = dbp_->CreateColumnFamily(rocksdb::ColumnFamilyOptions(),
-        BLOCKS_COLUMN_FAMILY, &blocks_cf);
-    BITCOIN_ASSERT_MSG(status.ok(), "Failed to create blocks column family");
-    column_family_handles_.push_back(blocks_cf);
+    // A new store is indexed from genesis.
+    catalog_live_ = catalog_;
 
-    status = dbp_->CreateColumnFamily(rocksdb::ColumnFamilyOptions(),
-        BLOCK_TRANSACTIONS_COLUMN_FAMILY, &blocks_cf);
-    BITCOIN_ASSERT_MSG(status.ok(), "Failed to create block transactions column family");
-    column_family_handles_.push_back(blocks_cf);
+    auto context = begin_transaction();
+    if (push(context, genesis) != error::success)
+        return false;
 
-    closed_ = false;
-    auto context = std::make_shared<transaction_context>(db_);
-    context->begin();
-    return push(context, genesis) == error::success;
-    context->commit();
+    return commit_transaction(context);
 }
 
 bool
 data_base::open()
 {
-    std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
-    column_families.push_back(rocksdb::ColumnFamilyDescriptor(
-            rocksdb::kDefaultColumnFamilyName, rocksdb::ColumnFamilyOptions()));
-    column_families.push_back(rocksdb::ColumnFamilyDescriptor(TRANSACTIONS_COLUMN_FAMILY,
-            rocksdb::ColumnFamilyOptions()));
-    column_families.push_back(rocksdb::ColumnFamilyDescriptor(BLOCKS_COLUMN_FAMILY,
-            rocksdb::ColumnFamilyOptions()));
-    column_families.push_back(rocksdb::ColumnFamilyDescriptor(BLOCK_TRANSACTIONS_COLUMN_FAMILY,
-            rocksdb::ColumnFamilyOptions()));
+    if (!open(database_options()))
+        return false;
 
-    rocksdb::Options options;
-    rocksdb::Status status = rocksdb::OptimisticTransactionDB::Open(options, directory_.string(),
-        column_families, &column_family_handles_, &dbp_);
+    // A store not closed cleanly has its most recent blocks verified.
+    if (clean_shutdown() || recover())
+        return true;
+
+    // A divergent store is not marked clean, so is verified again on open.
+    close();
+    return false;
+}
+
+// private
+bool
+data_base::open(const rocksdb::Options& options)
+{
+    rocksdb::Status status = rocksdb::OptimisticTransactionDB::Open(options,
+        directory_.string(), column_families(), &column_family_handles_,
+        &dbp_);
     if (!status.ok()) {
         std::cerr << status.ToString() << std::endl;
         return false;
     }
 
+    db_ = std::shared_ptr<rocksdb::OptimisticTransactionDB>(dbp_);
+
+    const auto unspent_capacity = settings_.cache_capacity != 0 ?
+        settings_.cache_capacity : settings_.memory_budget / unspent_share /
+            unspent_transaction_size;
+
     transactions_ = std::make_shared<transaction_database>(db_,
-        column_family_handles_[1], CACHE_CAPACITY);
+        handle(TRANSACTIONS_COLUMN_FAMILY),
+        handle(TRANSACTION_METADATA_COLUMN_FAMILY),
+        settings_.memory_pool ? nullptr : handle(POOL_COLUMN_FAMILY),
+        unspent_capacity, settings_.unspent_spent_window,
+        settings_.pool_expiry, pool_bytes(settings_), stats_);
     blocks_ = std::make_shared<block_database>(db_,
-        column_family_handles_[2], column_family_handles_[3]);
+        handle(BLOCKS_COLUMN_FAMILY),
+        handle(BLOCK_STATE_COLUMN_FAMILY),
+        handle(BLOCK_TRANSACTIONS_COLUMN_FAMILY),
+        handle(BLOCK_INDEX_COLUMN_FAMILY), stats_);
+    payments_ = std::make_shared<payment_database>(db_,
+        handle(PAYMENTS_COLUMN_FAMILY));
+    filters_ = std::make_shared<filter_database>(db_,
+        handle(FILTERS_COLUMN_FAMILY), *blocks_);
+
+    start_pools();
 
+    // The catalog is live only if indexed through the confirmed top.
+    size_t top, indexed;
+    const auto context = begin_transaction(true);
+    const auto confirmed = blocks_->top(context, top, false);
+    catalog_live_ = catalog_ && catalog_height(context, indexed) &&
+        confirmed && indexed == top;
+    filter_gap_ = false;
+
+    for (const auto& filter: { prune_transactions_.get(),
+        prune_block_transactions_.get(), prune_filters_.get() })
+        if (filter != nullptr)
+            filter->open(dbp_, handle(BLOCKS_COLUMN_FAMILY),
+                handle(TRANSACTION_METADATA_COLUMN_FAMILY));
+
+    if (confirmed)
+        prune(top);
+
+    consistent_ = true;
     closed_ = false;
     return true;
 }
 
+// private
+void
+data_base::start_pools()
+{
+    queries_ = std::make_shared<query_pool>(settings_.query_threads,
+        settings_.query_max_in_flight);
+    prefetches_ = std::make_shared<query_pool>(settings_.prefetch_threads,
+        settings_.prefetch_max_blocks);
+}
+
+// private
+rocksdb::ColumnFamilyHandle*
+data_base::handle(const std::string& name) const
+{
+    for (const auto handle: column_family_handles_)
+        if (handle->GetName() == name)
+            return handle;
+
+    BITCOIN_ASSERT_MSG(false, "Missing column family handle");
+    return nullptr;
+}
+
+// private
+// Blocks deeper than the prune depth are pruned as compacted. Verification
+// on open (and so reorganization) is assured to the verify depth.
+void
+data_base::prune(size_t top)
+{
+    if (settings_.prune_depth == 0)
+        return;
+
+    const auto depth = std::max(settings_.prune_depth,
+        settings_.verify_depth);
+    const auto height = top < depth ? 0 : top - depth + 1;
+
+    for (const auto& filter: { prune_transactions_.get(),
+        prune_block_transactions_.get(), prune_filters_.get() })
+        if (filter != nullptr)
+            filter->set_height(height);
+}
+
 bool
 data_base::close()
 {
     if (closed_){
         return false;
     }
+
+    // Queued queries complete (releasing their views) before the store is
+    // closed.
+    if (queries_)
+        queries_->stop();
+    if (prefetches_)
+        prefetches_->stop();
+
+    // A catalog build holds views of its own, so is stopped to count those
+    // of callers, and resumed from its last chunk if the close is refused.
+    const auto stopped = stop_catalog();
+
+    // rocksdb aborts close while a snapshot is held, and handles cannot be
+    // restored once destroyed, so the store is left open (and queryable).
+    uint64_t snapshots;
+    if (!db_->GetIntProperty(rocksdb::DB::Properties::kNumSnapshots,
+        &snapshots) || snapshots > 0)
+    {
+        LOG_ERROR(LOG_DATABASE)
+            << "Store not closed, read views outstanding.";
+        start_pools();
+
+        if (stopped)
+            index_catalog(indexer_threads_, indexer_progress_,
+                indexer_complete_);
+
+        return false;
+    }
+
+    if (stopped && indexer_complete_)
+        indexer_complete_(error::service_stopped);
+
+    // A filter build holds no views, so is stopped only if closing.
+    stop_filters();
+
+    queries_.reset();
+    prefetches_.reset();
+
+    // Pruning reads through the handles, so stops before they are destroyed.
+    for (const auto& filter: { prune_transactions_.get(),
+        prune_block_transactions_.get(), prune_filters_.get() })
+        if (filter != nullptr)
+            filter->close();
+
+    // Writes without the write ahead log are persisted before marked clean.
+    if (settings_.disable_wal && !db_->Flush(rocksdb::FlushOptions(),
+        column_family_handles_).ok())
+        consistent_ = false;
+
+    // A store found divergent is verified again on the next open.
+    if (consistent_ && !set_clean_shutdown())
+        LOG_ERROR(LOG_DATABASE) << "Failed to mark clean shutdown.";
+
     for (auto handle : column_family_handles_) {
         auto s = dbp_->DestroyColumnFamilyHandle(handle);
         BITCOIN_ASSERT_MSG(s.ok(), "Failed to close rocks db");
     }
-    auto status = dbp_->Close();
-    if (!status.ok()){
+    column_family_handles_.clear();
+
+    // The handles are released, so the store is released even if the close
+    // fails (on an I/O error), and is not closed again on destruct.
+    const auto status = dbp_->Close();
+    if (!status.ok())
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to close store: " << status.ToString();
+
+    transactions_.reset();
+    blocks_.reset();
+    payments_.reset();
+    filters_.reset();
+    db_.reset();
+    closed_ = true;
+    return status.ok();
+}
+
+// Recovery.
+// ----------------------------------------------------------------------------
+// private
+
+// The marker is written on close and deleted on open, so is absent (on open)
+// only if the store was not closed.
+static const std::string clean_shutdown_key = "clean_shutdown";
+
+bool
+data_base::clean_shutdown()
+{
+    const auto family = handle(rocksdb::kDefaultColumnFamilyName);
+    std::string value;
+    const auto status = db_->Get(rocksdb::ReadOptions(), family,
+        clean_shutdown_key, &value);
+
+    if (!status.ok())
         return false;
+
+    rocksdb::WriteOptions options;
+    options.sync = true;
+    return db_->Delete(options, family, clean_shutdown_key).ok();
+}
+
+bool
+data_base::set_clean_shutdown()
+{
+    rocksdb::WriteOptions options;
+    options.sync = true;
+    return db_->Put(options, handle(rocksdb::kDefaultColumnFamilyName),
+        clean_shutdown_key, rocksdb::Slice()).ok();
+}
+
+// Writes are transactional, so divergence implies corruption of the most
+// recent writes. Only the index is trusted, block state and tx confirmation
+// are repaired from it. Verification reads through one snapshot in parallel.
+bool
+data_base::recover()
+{
+    const auto depth = settings_.verify_depth;
+    if (depth == 0)
+        return true;
+
+    LOG_INFO(LOG_DATABASE)
+        << "Store not closed cleanly, verifying " << depth << " blocks.";
+
+    const auto view = begin_scan();
+    const auto context = begin_transaction();
+    auto repaired = false;
+
+    for (const auto candidate: { true, false })
+    {
+        size_t top;
+        if (!blocks_->top(view, top, candidate))
+            continue;
+
+        const auto first = top < depth ? 0 : top - depth + 1;
+        const auto results = verify(view, *blocks_, *transactions_, first,
+            top, candidate, settings_.verify_threads);
+
+        for (size_t index = 0; index < results.size(); ++index)
+        {
+            const auto height = first + index;
+            const auto& ec = results[index];
+
+            if (ec == error::store_incorrect_state &&
+                repair(context, height, candidate))
+            {
+                repaired = true;
+                continue;
+            }
+
+            if (ec)
+            {
+                LOG_ERROR(LOG_DATABASE)
+                    << "Store diverges at " << (candidate ? "candidate" :
+                        "confirmed") << " height " << height << ": "
+                    << ec.message();
+
+                consistent_ = false;
+                return false;
+            }
+        }
     }
-    closed_ = true;
+
+    if (repaired && !commit_transaction(context))
+    {
+        consistent_ = false;
+        return false;
+    }
+
+    LOG_INFO(LOG_DATABASE)
+        << "Store verified" << (repaired ? " and repaired." : ".");
+    return true;
+}
+
+// The block is promoted to the index state and its txs (re)confirmed.
+bool
+data_base::repair(std::shared_ptr<transaction_context> context,
+    size_t height, bool candidate)
+{
+    const auto result = blocks_->get(context, height, candidate);
+    if (!result)
+        return false;
+
+    const auto state = result.state();
+    if (candidate && !is_candidate(state) && !is_confirmed(state))
+        return blocks_->promote(context, result.hash(), height, true);
+
+    if (candidate)
+        return true;
+
+    if (!is_confirmed(state) &&
+        !blocks_->promote(context, result.hash(), height, false))
+        return false;
+
+    const auto hashes = result.transaction_hashes();
+    for (size_t position = 0; position < hashes.size(); ++position)
+        if (!transactions_->confirm(context, hashes[position], height,
+            result.median_time_past(), position))
+            return false;
+
+    return true;
+}
+
+// Backup.
+// ----------------------------------------------------------------------------
+
+// Checkpoint flushes all (atomically flushed) families and hard links files.
+bool
+data_base::checkpoint(const path& directory) const
+{
+    if (closed_)
+        return false;
+
+    rocksdb::Checkpoint* checkpoint;
+    auto status = rocksdb::Checkpoint::Create(dbp_, &checkpoint);
+    if (!status.ok()) {
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to create checkpoint: " << status.ToString();
+        return false;
+    }
+
+    const std::unique_ptr<rocksdb::Checkpoint> owner(checkpoint);
+    status = checkpoint->CreateCheckpoint(directory.string());
+    if (!status.ok()) {
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to write checkpoint: " << status.ToString();
+        return false;
+    }
+
+    return true;
+}
+
+// Files shared with previous backups are not copied again.
+bool
+data_base::backup(const path& backup_directory, bool verify) const
+{
+    if (closed_)
+        return false;
+
+    // Backups are restored into a single directory.
+    if (!settings_.data_paths.empty() || !settings_.family_paths.empty())
+    {
+        LOG_ERROR(LOG_DATABASE) << "Backup of a tiered store not supported.";
+        return false;
+    }
+
+    rocksdb::BackupEngine* engine;
+    auto status = rocksdb::BackupEngine::Open(rocksdb::Env::Default(),
+        rocksdb::BackupEngineOptions(backup_directory.string()), &engine);
+    if (!status.ok()) {
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to open backup engine: " << status.ToString();
+        return false;
+    }
+
+    const std::unique_ptr<rocksdb::BackupEngine> owner(engine);
+
+    // Flushing (atomically) keeps the backup independent of the log.
+    rocksdb::CreateBackupOptions backup_options;
+    backup_options.flush_before_backup = true;
+
+    rocksdb::BackupID backup_id;
+    status = engine->CreateNewBackup(backup_options, dbp_, &backup_id);
+    if (!status.ok()) {
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to create backup: " << status.ToString();
+        return false;
+    }
+
+    if (verify) {
+        status = engine->VerifyBackup(backup_id, true);
+        if (!status.ok()) {
+            LOG_ERROR(LOG_DATABASE)
+                << "Failed to verify backup: " << status.ToString();
+            return false;
+        }
+    }
+
+    return engine->PurgeOldBackups(settings_.backups_retained).ok();
+}
+
+bool
+data_base::restore(const path& backup_directory, const path& directory)
+{
+    rocksdb::BackupEngineReadOnly* engine;
+    auto status = rocksdb::BackupEngineReadOnly::Open(rocksdb::Env::Default(),
+        rocksdb::BackupEngineOptions(backup_directory.string()), &engine);
+    if (!status.ok()) {
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to open backup engine: " << status.ToString();
+        return false;
+    }
+
+    const std::unique_ptr<rocksdb::BackupEngineReadOnly> owner(engine);
+    status = engine->RestoreDBFromLatestBackup(directory.string(),
+        directory.string());
+    if (!status.ok()) {
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to restore backup: " << status.ToString();
+        return false;
+    }
+
+    return true;
+}
+
+// Compaction.
+// ----------------------------------------------------------------------------
+
+// The bottommost level is rewritten even if it alone holds the range, as
+// records are pruned only in bottommost compactions.
+bool
+data_base::compact()
+{
+    if (closed_)
+        return false;
+
+    rocksdb::CompactRangeOptions options;
+    options.bottommost_level_compaction =
+        rocksdb::BottommostLevelCompaction::kForce;
+
+    for (const auto handle: column_family_handles_)
+        if (!db_->CompactRange(options, handle, nullptr, nullptr).ok())
+            return false;
+
     return true;
 }
 
 std::shared_ptr<transaction_context>
 data_base::begin_transaction(bool use_snapshot)
 {
-    auto context = std::make_shared<transaction_context>(db_);
+    // A commit without the write ahead log cannot be synced.
+    rocksdb::WriteOptions options;
+    options.disableWAL = settings_.disable_wal;
+    options.sync = settings_.sync_writes && !settings_.disable_wal;
+
+    auto context = std::make_shared<transaction_context>(db_, options);
     context->begin(use_snapshot);
     return context;
 }
@@ -130,51 +820,752 @@ data_base::begin_transaction(bool use_snapshot)
 bool
 data_base::commit_transaction(std::shared_ptr<transaction_context> context)
 {
+    const perf_stats::sample sample(stats_, perf_stats::commit);
     return context->commit();
 }
 
+std::shared_ptr<read_view>
+data_base::begin_read(bool fill_cache, size_t readahead) const
+{
+    return std::make_shared<read_view>(db_, fill_cache, readahead);
+}
+
+// Bulk passes read history once, so must not evict the working set.
+std::shared_ptr<read_view>
+data_base::begin_scan() const
+{
+    return begin_read(false, settings_.scan_readahead);
+}
+
+// Asynchronous queries.
+// ----------------------------------------------------------------------------
+
+void
+data_base::get_block(const hash_digest& hash, block_handler handler) const
+{
+    if (closed_)
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto view = begin_read();
+    const auto blocks = blocks_;
+
+    if (!queries_->post([=]()
+    {
+        const auto result = blocks->get(view, hash);
+        handler(result ? error::success : error::not_found, result);
+    }))
+        handler(error::oversubscribed, {});
+}
+
+void
+data_base::get_block(size_t height, bool candidate,
+    block_handler handler) const
+{
+    if (closed_)
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto view = begin_read();
+    const auto blocks = blocks_;
+
+    if (!queries_->post([=]()
+    {
+        const auto result = blocks->get(view, height, candidate);
+        handler(result ? error::success : error::not_found, result);
+    }))
+        handler(error::oversubscribed, {});
+}
+
+void
+data_base::get_transaction(const hash_digest& hash,
+    transaction_handler handler) const
+{
+    if (closed_)
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto view = begin_read();
+    const auto transactions = transactions_;
+
+    if (!queries_->post([=]()
+    {
+        const auto result = transactions->get(view, hash);
+        handler(result ? error::success : error::not_found, result);
+    }))
+        handler(error::oversubscribed, {});
+}
+
+// The point metadata is populated, so the point must outlive the query.
+void
+data_base::get_output(const output_point& point, size_t fork_height,
+    output_handler handler) const
+{
+    if (closed_)
+    {
+        handler(error::service_stopped, point);
+        return;
+    }
+
+    // The caller's point may not outlive the query, so a copy is populated.
+    const auto view = begin_read();
+    const auto transactions = transactions_;
+    const output_point prevout(point.hash(), point.index());
+
+    if (!queries_->post([=]()
+    {
+        handler(transactions->get_output(view, prevout, fork_height) ?
+            error::success : error::not_found, prevout);
+    }))
+        handler(error::oversubscribed, point);
+}
+
+block_iterator
+data_base::read_blocks(size_t first, size_t last) const
+{
+    return
+    {
+        begin_scan(), *blocks_, *transactions_, first, last,
+        settings_.block_prefetch_window, queries_
+    };
+}
+
+bool
+data_base::scan_transactions(transaction_database::visitor handler) const
+{
+    return !closed_ && transactions_->scan(begin_scan(), handler);
+}
+
 system::code
 data_base::push(std::shared_ptr<transaction_context> context,
     const system::chain::block& block, size_t height,
     uint32_t median_time_past)
 {
+    code ec;
+
     // Store the header.
     blocks_->store(context, block.header(), height, median_time_past);
 
-    // // Push header reference onto the candidate index and set candidate state.
-    // if (!blocks_->promote(context, block.hash(), height, true))
-    //     return error::operation_failed;
+    // Push header reference onto the candidate index and set candidate state.
+    if (!blocks_->promote(context, block.hash(), height, true))
+        return error::operation_failed;
+
+    // Store any missing txs as unconfirmed, set tx link metadata for all.
+    if (!transactions_->store(context, block.transactions()))
+        return error::operation_failed;
+
+    // Populate transaction references from link metadata.
+    if (!blocks_->update_transactions(context, block))
+        return error::operation_failed;
+
+    // Build the filter in parallel with indexing and confirmation, unless
+    // filters are being filled (when it could not be stored).
+    data_chunk filter_data;
+    auto built = filter_gap_ ? std::future<bool>{} :
+        build_filter(context, block, filter_data);
+
+    // Index payments while spent outputs are still cached.
+    if ((ec = catalog(context, block, height)))
+        return ec;
+
+    // Confirm all transactions (candidate state transition not requried).
+    if (!transactions_->confirm(context, block, height, median_time_past))
+        return error::operation_failed;
+
+    // Promote validation state to valid (presumed valid).
+    if (!blocks_->validate(context, block.hash(), error::success))
+        return error::operation_failed;
+
+    // A missing filter does not fail the block, the gap is filled.
+    if (!filter(context, block, built, filter_data))
+        index_filters();
+
+    // Push header reference onto the confirmed index and set confirmed state.
+    if (!blocks_->promote(context, block.hash(), height, false))
+        return error::operation_failed;
+
+    return error::success;
+}
+
+// Previous outputs are read once into the unspent output cache, so are not
+// also retained in the block cache.
+bool
+data_base::prefetch(block_const_ptr block)
+{
+    if (closed_)
+        return false;
+
+    const auto view = begin_read(false);
+    const auto transactions = transactions_;
+
+    return prefetches_->post([=]()
+    {
+        transactions->prefetch(view, *block);
+    });
+}
+
+system::code
+data_base::confirm(const hash_digest& block_hash, size_t height)
+{
+    code ec;
+
+    // Wait out backpressure before taking any lock.
+    throttle();
+    auto context = begin_transaction();
+
+    // Critical Section (excludes the catalog going live mid-confirmation).
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(catalog_mutex_);
+
+    const auto result = blocks_->get(context, block_hash);
+    if (!result || !is_candidate(result.state()))
+        return error::operation_failed;
+
+    const chain::block block(result.header(), transactions_->get(context,
+        result.transaction_hashes()));
+    if (block.transactions().empty())
+        return error::operation_failed;
+
+    // Build the filter in parallel with indexing and confirmation, unless
+    // filters are being filled (when it could not be stored).
+    data_chunk filter_data;
+    auto built = filter_gap_ ? std::future<bool>{} :
+        build_filter(context, block, filter_data);
+
+    // Index payments while spent outputs are still cached.
+    if ((ec = catalog(context, block, height)))
+        return ec;
+
+    // Confirm all transactions and mark their spent outputs.
+    if (!transactions_->confirm(context, block, height,
+        result.median_time_past()))
+        return error::operation_failed;
+
+    // A missing filter does not fail the block, the gap is filled.
+    if (!filter(context, block, built, filter_data))
+        index_filters();
+
+    // Push header reference onto the confirmed index and set confirmed state.
+    if (!blocks_->promote(context, block_hash, height, false))
+        return error::operation_failed;
+
+    if (!commit_transaction(context))
+        return error::operation_failed;
+
+    prune(height);
+    return error::success;
+}
+
+system::code
+data_base::store(const transaction& tx, uint32_t forks)
+{
+    auto context = begin_transaction();
+
+    // Critical Section (excludes the catalog going live mid-store).
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(catalog_mutex_);
+
+    // Write the transaction and cache its outputs.
+    if (!transactions_->store(context, tx, forks))
+        return error::operation_failed;
+
+    // The tx existed, so its payments are already indexed. Txs pooled while
+    // the catalog is deferred are indexed as it goes live.
+    if (catalog_live_ && !tx.metadata.existed && !payments_->catalog(context,
+        tx, payment_result::unconfirmed, transaction_result::unconfirmed))
+        return error::operation_failed;
 
-    // // Store any missing txs as unconfirmed, set tx link metadata for all.
-    // if (!transactions_->store(context, block.transactions()))
-    //     return error::operation_failed;
+    return commit_transaction(context) ? error::success :
+        error::operation_failed;
+}
+
+system::code
+data_base::catalog(const transaction& tx)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(catalog_mutex_);
 
-    // // Populate transaction references from link metadata.
-    // if (!blocks_->update_transactions(context, block))
-    //     return error::operation_failed;
+    if (!catalog_live_)
+        return error::success;
 
-    // // Confirm all transactions (candidate state transition not requried).
-    // if (!transactions_->confirm(context, block, height, median_time_past))
-    //     return error::operation_failed;
+    auto context = begin_transaction();
 
-    // // Promote validation state to valid (presumed valid).
-    // if (!blocks_->validate(context, block.hash(), error::success))
-    //     return error::operation_failed;
+    if (!payments_->catalog(context, tx, payment_result::unconfirmed,
+        transaction_result::unconfirmed))
+        return error::operation_failed;
 
-    // // TODO (kp) Bring these back when filter and catalog are supported
-    // // if ((ec = filter(block)))
-    // //     return ec;
+    return commit_transaction(context) ? error::success :
+        error::operation_failed;
+}
 
-    // // if ((ec = catalog(block)))
-    // //     return ec;
+// private
+system::code
+data_base::catalog(std::shared_ptr<transaction_context> context,
+    const block& block, size_t height)
+{
+    if (!catalog_)
+        return error::success;
 
-    // // Push header reference onto the confirmed index and set confirmed state.
-    // if (!blocks_->promote(context, block.hash(), height, false))
-    //     return error::operation_failed;
+    // A deferred catalog is built by index_catalog.
+    if (!catalog_live_)
+        return uncatalog(context, block);
+
+    return index(context, block, height);
+}
+
+// private
+// While deferred, payments indexed for pooled txs of the block are removed,
+// as the block is then indexed by index_catalog, not by confirmation.
+system::code
+data_base::uncatalog(std::shared_ptr<transaction_context> context,
+    const block& block)
+{
+    for (const auto& tx: block.transactions())
+    {
+        if (!payments_->cataloged(context, tx, payment_result::unconfirmed,
+            transaction_result::unconfirmed))
+            continue;
+
+        transactions_->get_prevouts(context, tx, max_size_t);
+
+        if (!payments_->uncatalog(context, tx, payment_result::unconfirmed,
+            transaction_result::unconfirmed))
+            return error::operation_failed;
+    }
 
     return error::success;
 }
 
+// private
+// Payments of the block replace any payments indexed for its pooled txs.
+system::code
+data_base::index(std::shared_ptr<transaction_context> context,
+    const block& block, size_t height)
+{
+    const auto& txs = block.transactions();
+
+    for (size_t position = 0; position < txs.size(); ++position)
+    {
+        const auto& tx = txs[position];
+
+        // Spends are indexed by previous output script, which validation
+        // populates, otherwise the previous output is read from the store.
+        transactions_->get_prevouts(context, tx, max_size_t);
+
+        // Only a pooled tx has unconfirmed payments (one read, no writes).
+        if (payments_->cataloged(context, tx, payment_result::unconfirmed,
+            transaction_result::unconfirmed) && !payments_->uncatalog(context,
+            tx, payment_result::unconfirmed, transaction_result::unconfirmed))
+            return error::operation_failed;
+
+        if (!payments_->catalog(context, tx, height, position))
+            return error::operation_failed;
+    }
+
+    return set_catalog_height(context, height) ? error::success :
+        error::operation_failed;
+}
+
+// private
+// The store is read here, as transactions are not thread safe, so that the
+// filter can then be computed on another thread from the block alone.
+std::future<bool>
+data_base::build_filter(std::shared_ptr<transaction_context> context,
+    const block& block, data_chunk& out_filter)
+{
+    // A filter is never rebuilt, as it does not change with reorganization.
+    if (!filter_ || filters_->get(context, block.hash()))
+        return {};
+
+    // The filter includes the previous output script of each input.
+    for (const auto& tx: block.transactions())
+    {
+        transactions_->get_prevouts(context, tx, max_size_t);
+
+        // Later population must not race the filter computation.
+        if (!tx.is_coinbase())
+            for (const auto& input: tx.inputs())
+                if (!input.previous_output().metadata.cache.is_valid())
+                    return std::async(std::launch::deferred, []()
+                    {
+                        return false;
+                    });
+    }
+
+    return std::async(std::launch::async, [&block, &out_filter]()
+    {
+        return filter_database::compute(block, out_filter);
+    });
+}
+
+// private
+// The filter is awaited even if not stored, as it refers to the block.
+bool
+data_base::filter(std::shared_ptr<transaction_context> context,
+    const block& block, std::future<bool>& built, const data_chunk& filter)
+{
+    if (!built.valid())
+        return true;
+
+    if (built.get() && filters_->store(context, block.header(), filter))
+        return true;
+
+    LOG_ERROR(LOG_DATABASE)
+        << "Filter not stored for block " << encode_hash(block.hash());
+    return false;
+}
+
+// Filters.
+// ----------------------------------------------------------------------------
+
+bool
+data_base::index_filters(result_handler complete)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(filter_mutex_);
+
+    if (closed_ || !filter_ || filtering_)
+        return false;
+
+    // A finished build is joined before it is replaced.
+    if (filter_thread_.joinable())
+        filter_thread_.join();
+
+    filter_gap_ = true;
+    filters_stopped_ = false;
+    filtering_ = true;
+
+    filter_thread_ = std::thread([this, complete]()
+    {
+        const auto ec = build_filters();
+
+        // A failed build leaves the gap (and confirmation skips filters)
+        // until started again (or reopened).
+        if (ec && ec != error::service_stopped)
+            LOG_ERROR(LOG_DATABASE)
+                << "Filter build failed: " << ec.message();
+
+        if (!ec)
+            filter_gap_ = false;
+
+        if (complete)
+            complete(ec);
+
+        filtering_ = false;
+    });
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void
+data_base::stop_filters()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(filter_mutex_);
+
+    filters_stopped_ = true;
+
+    if (filter_thread_.joinable())
+        filter_thread_.join();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Each filter commits to the filter of its previous block, so a gap is
+// filled from the last filtered confirmed block, or genesis, through the
+// confirmed top, until no blocks are confirmed unfiltered meanwhile.
+system::code
+data_base::build_filters()
+{
+    while (true)
+    {
+        size_t top;
+        auto context = begin_transaction();
+
+        if (!blocks_->top(context, top, false))
+            return error::operation_failed;
+
+        auto first = top + 1;
+        for (; first > 0; --first)
+        {
+            if (filters_stopped_)
+                return error::service_stopped;
+
+            const auto result = blocks_->get(context, first - 1, false);
+            if (!result)
+                return error::operation_failed;
+
+            if (filters_->get(context, result.hash()))
+                break;
+        }
+
+        if (first > top)
+            return error::success;
+
+        LOG_INFO(LOG_DATABASE)
+            << "Building filters from " << first << " to " << top;
+
+        for (auto height = first; height <= top; ++height)
+        {
+            // Filters built so far are kept.
+            if (filters_stopped_)
+                return commit_transaction(context) ?
+                    error::service_stopped : error::operation_failed;
+
+            const auto result = blocks_->get(context, height, false);
+            if (!result)
+                return error::operation_failed;
+
+            const chain::block block(result.header(),
+                transactions_->get(context, result.transaction_hashes()));
+
+            // Transactions of pruned blocks are not available to filter.
+            if (block.transactions().empty())
+            {
+                LOG_ERROR(LOG_DATABASE)
+                    << "Cannot filter (pruned) height " << height;
+                commit_transaction(context);
+                return error::not_found;
+            }
+
+            data_chunk filter_data;
+            auto built = build_filter(context, block, filter_data);
+            if (!filter(context, block, built, filter_data))
+            {
+                commit_transaction(context);
+                return error::operation_failed;
+            }
+
+            if ((height - first + 1) % filter_commit_blocks != 0)
+                continue;
+
+            if (!commit_transaction(context))
+                return error::operation_failed;
+
+            context = begin_transaction();
+        }
+
+        if (!commit_transaction(context))
+            return error::operation_failed;
+    }
+}
+
+// Catalog.
+// ----------------------------------------------------------------------------
+
+// The indexed height is stored in the default family.
+static const std::string catalog_height_key = "catalog_height";
+
+bool
+data_base::catalog_live() const
+{
+    return catalog_live_;
+}
+
+void
+data_base::defer_catalog()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(catalog_mutex_);
+    catalog_live_ = false;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool
+data_base::index_catalog(size_t threads,
+    catalog_indexer::progress_handler progress, result_handler complete)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(indexer_mutex_);
+
+    if (closed_ || !catalog_ || catalog_live_ || indexing_)
+        return false;
+
+    // A finished build is joined before it is replaced.
+    if (indexer_thread_.joinable())
+        indexer_thread_.join();
+
+    indexer_ = std::make_shared<catalog_indexer>(db_, *blocks_,
+        *transactions_, handle(PAYMENTS_COLUMN_FAMILY),
+        directory_ / "catalog", threads, settings_.catalog_chunk_blocks);
+
+    indexer_threads_ = threads;
+    indexer_progress_ = progress;
+    indexer_complete_ = complete;
+    indexer_result_ = error::success;
+    indexing_ = true;
+
+    indexer_thread_ = std::thread([this, progress, complete]()
+    {
+        const auto ec = build_catalog(progress);
+        indexer_result_ = ec;
+
+        // A build stopped by close is resumed or reported by close.
+        if (ec != error::service_stopped)
+        {
+            if (ec)
+                LOG_ERROR(LOG_DATABASE)
+                    << "Catalog build failed: " << ec.message();
+
+            if (complete)
+                complete(ec);
+        }
+
+        indexing_ = false;
+    });
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Stop and join any catalog build, true if a build was stopped unfinished.
+bool
+data_base::stop_catalog()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(indexer_mutex_);
+
+    if (indexer_)
+        indexer_->stop();
+
+    if (indexer_thread_.joinable())
+        indexer_thread_.join();
+
+    indexer_.reset();
+
+    const auto stopped = indexer_result_ == error::service_stopped;
+    indexer_result_ = error::success;
+    return stopped;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Chunks are built in parallel until close to the top, the remainder is
+// indexed inline while confirmation is excluded, and the catalog goes live.
+system::code
+data_base::build_catalog(catalog_indexer::progress_handler handler)
+{
+    while (true)
+    {
+        size_t top, indexed;
+        auto context = begin_transaction(true);
+
+        if (!blocks_->top(context, top, false))
+            return error::operation_failed;
+
+        const auto first = catalog_height(context, indexed) ? indexed + 1 : 0;
+
+        // The snapshot is not held while chunks are indexed.
+        context.reset();
+
+        if (top < first + settings_.catalog_chunk_blocks)
+            break;
+
+        LOG_INFO(LOG_DATABASE)
+            << "Building catalog from " << first << " to " << top;
+
+        if (!indexer_->index(first, top, handler))
+            return indexer_->stopped() ? error::service_stopped :
+                error::operation_failed;
+
+        context = begin_transaction();
+        if (!set_catalog_height(context, top) || !commit_transaction(context))
+            return error::operation_failed;
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(catalog_mutex_);
+
+    size_t top, indexed;
+    auto context = begin_transaction();
+
+    if (!blocks_->top(context, top, false))
+        return error::operation_failed;
+
+    const auto first = catalog_height(context, indexed) ? indexed + 1 : 0;
+
+    for (auto height = first; height <= top; ++height)
+    {
+        const auto result = blocks_->get(context, height, false);
+        if (!result)
+            return error::operation_failed;
+
+        const chain::block block(result.header(), transactions_->get(context,
+            result.transaction_hashes()));
+
+        if (block.transactions().empty() || index(context, block, height))
+            return error::operation_failed;
+    }
+
+    // Txs pooled while deferred were not indexed by store.
+    const auto pooled = [&](const transaction& tx)
+    {
+        transactions_->get_prevouts(context, tx, max_size_t);
+        return payments_->catalog(context, tx, payment_result::unconfirmed,
+            transaction_result::unconfirmed);
+    };
+
+    if (!transactions_->scan_pool(context, pooled) ||
+        !commit_transaction(context))
+        return error::operation_failed;
+
+    catalog_live_ = true;
+    LOG_INFO(LOG_DATABASE) << "Catalog is live at " << top;
+
+    if (handler)
+        handler(top, top);
+
+    return error::success;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+bool
+data_base::catalog_height(std::shared_ptr<transaction_context> context,
+    size_t& out_height) const
+{
+    std::string value;
+    const auto status = context->get(
+        handle(rocksdb::kDefaultColumnFamilyName), catalog_height_key,
+        &value);
+
+    if (!status.ok() || value.size() != catalog_height_value::record::size)
+        return false;
+
+    out_height = catalog_height_value::height::get(codec::to_bytes(value));
+    return true;
+}
+
+// private
+bool
+data_base::set_catalog_height(std::shared_ptr<transaction_context> context,
+    size_t height)
+{
+    BITCOIN_ASSERT(height <= max_uint32);
+    catalog_height_value::record::type data;
+    catalog_height_value::height::put(data.data(),
+        static_cast<uint32_t>(height));
+
+    return context->txn()->Put(handle(rocksdb::kDefaultColumnFamilyName),
+        catalog_height_key, to_slice(data)).ok();
+}
+
 // Reader interfaces.
 // ----------------------------------------------------------------------------
 // public
@@ -189,5 +1580,48 @@ const transaction_database& data_base::transactions() const
     return *transactions_;
 }
 
+const payment_database& data_base::payments() const
+{
+    return *payments_;
+}
+
+const filter_database& data_base::filters() const
+{
+    return *filters_;
+}
+
+const perf_stats& data_base::stats() const
+{
+    return stats_;
+}
+
+const write_pressure& data_base::pressure() const
+{
+    return *pressure_;
+}
+
+// Backpressure.
+// ----------------------------------------------------------------------------
+
+bool
+data_base::backpressure() const
+{
+    return pressure_->backpressure(settings_.compaction_debt_limit);
+}
+
+// private
+void
+data_base::throttle() const
+{
+    if (!settings_.throttle_writes || !backpressure())
+        return;
+
+    if (!pressure_->wait(settings_.compaction_debt_limit,
+        std::chrono::milliseconds(settings_.throttle_timeout)))
+        LOG_VERBOSE(LOG_DATABASE)
+            << "Write throttle timed out, compaction debt: "
+            << pressure_->get().compaction_debt;
+}
+
 } // namespace database
 } // namespace libbitcoin
@@ -18,12 +18,19 @@
  */
 #include <bitcoin/database/databases/block_database.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <bitcoin/system.hpp>
+#include <bitcoin/database/codec.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/layouts.hpp>
 #include <bitcoin/database/result/block_result.hpp>
+#include <bitcoin/database/slice.hpp>
 #include "rocksdb/db.h"
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
@@ -35,35 +42,131 @@ using namespace bc::system;
 using namespace bc::system::chain;
 using namespace bc::system::machine;
 
-static const auto header_size = header::satoshi_fixed_size();
-static constexpr auto median_time_past_size = sizeof(uint32_t);
-static constexpr auto height_size = sizeof(uint32_t);
-static constexpr auto state_size = sizeof(uint8_t);
-static constexpr auto checksum_size = sizeof(uint32_t);
+// Candidate and confirmed indexes share a family, keyed by index and height.
+static constexpr uint8_t candidate_index = 0;
+static constexpr uint8_t confirmed_index = 1;
+static constexpr auto index_key_size = block_index_key::record::size;
+static constexpr auto block_size = block_value::record::size;
+static constexpr auto state_size = block_state_value::record::size;
 
-static const auto height_offset = header_size + median_time_past_size;
-static const auto state_offset = height_offset + height_size;
-static const auto checksum_offset = state_offset + state_size;
-
-// Total size of block header and metadata storage without neutrino filter offset.
-static const auto base_block_size = header_size + median_time_past_size +
-    height_size + state_size + checksum_size;
+// Heights are big-endian so that keys are ordered by height.
+static block_index_key::record::type index_key(size_t height, bool candidate)
+{
+    BITCOIN_ASSERT(height <= max_uint32);
+    block_index_key::record::type key;
+    block_index_key::index::put(key.data(),
+        candidate ? candidate_index : confirmed_index);
+    block_index_key::height::put(key.data(), static_cast<uint32_t>(height));
+    return key;
+}
 
 block_database::block_database(std::shared_ptr<rocksdb::OptimisticTransactionDB> db_,
     rocksdb::ColumnFamilyHandle* block_handle_,
-    rocksdb::ColumnFamilyHandle* block_transactions_handle_)
-  : db_(db_), block_handle_(block_handle_), block_transactions_handle_(block_transactions_handle_)
+    rocksdb::ColumnFamilyHandle* block_state_handle_,
+    rocksdb::ColumnFamilyHandle* block_transactions_handle_,
+    rocksdb::ColumnFamilyHandle* block_index_handle_, perf_stats& stats)
+  : db_(db_), block_handle_(block_handle_),
+    block_state_handle_(block_state_handle_),
+    block_transactions_handle_(block_transactions_handle_),
+    block_index_handle_(block_index_handle_), stats_(stats)
 {
 }
 
-// block_result
-// block_database::get(std::shared_ptr<transaction_context> context,
-//         const system::hash_digest& hash) const
-// {
-//     std::string value;
-//     context->txn()->Get(rocksdb::ReadOptions(), handle_, hash, &value);
-// }
+// Queries.
+// ----------------------------------------------------------------------------
+
+bool block_database::top(std::shared_ptr<reader> context,
+    size_t& out_height, bool candidate) const
+{
+    const auto last = index_key(max_uint32, candidate);
+    const std::unique_ptr<rocksdb::Iterator> iterator(context->iterator(
+        block_index_handle_, context->read_options()));
+
+    // The last key of the index is its top, if the index is not empty.
+    iterator->SeekForPrev(to_slice(last));
+    if (!iterator->Valid() || iterator->key().size() != index_key_size ||
+        iterator->key()[0] != static_cast<char>(last.front()))
+        return false;
+
+    out_height = block_index_key::height::get(
+        codec::to_bytes(iterator->key()));
+    return true;
+}
+
+block_result block_database::get(std::shared_ptr<reader> context,
+    size_t height, bool candidate) const
+{
+    hash_digest hash;
+    return read_index(context, height, candidate, hash) ?
+        get(context, hash) : block_result{};
+}
+
+block_result block_database::get(std::shared_ptr<reader> context,
+    const hash_digest& hash) const
+{
+    // The header and its state are read as one batch.
+    const perf_stats::sample sample(stats_, perf_stats::get_block);
+    const auto key = to_slice(hash);
+    std::vector<std::string> values;
+    const auto statuses = context->multi_get(
+        { block_handle_, block_state_handle_ }, { key, key }, &values);
+
+    if (!statuses[0].ok() || !statuses[1].ok() ||
+        values[0].size() != block_size || values[1].size() != state_size)
+        return {};
+
+    const auto data = codec::to_bytes(values[0]);
+    const auto state = codec::to_bytes(values[1]);
+    const auto header_data = block_value::header::data(data);
+    auto deserial = make_safe_deserializer(header_data,
+        header_data + block_value::header::size);
+
+    chain::header header;
+    header.from_data(deserial, false);
+
+    return
+    {
+        context, block_transactions_handle_, header,
+        block_value::height::get(data),
+        block_value::median_time_past::get(data),
+        block_state_value::state::get(state),
+        block_state_value::checksum::get(state)
+    };
+}
+
+// The index is read as one ordered range rather than a lookup per height.
+hash_list block_database::get_hashes(std::shared_ptr<reader> context,
+    size_t first, size_t last, bool candidate) const
+{
+    hash_list hashes;
+    if (first > last)
+        return hashes;
+
+    const auto start = index_key(first, candidate);
+    const auto stop = index_key(last, candidate);
+    const std::unique_ptr<rocksdb::Iterator> iterator(context->iterator(
+        block_index_handle_, context->read_options()));
+
+    auto height = first;
+    for (iterator->Seek(to_slice(start)); iterator->Valid() &&
+        iterator->key().compare(to_slice(stop)) <= 0; iterator->Next())
+    {
+        const auto key = iterator->key();
+        const auto value = iterator->value();
+        if (key.size() != index_key_size || value.size() != hash_size ||
+            key != to_slice(index_key(height++, candidate)))
+            break;
 
+        hash_digest hash;
+        std::copy(value.data(), value.data() + hash_size, hash.begin());
+        hashes.push_back(hash);
+    }
+
+    return hashes;
+}
+
+// Writers.
+// ----------------------------------------------------------------------------
 
 void block_database::store(std::shared_ptr<transaction_context> context,
     const system::chain::header& header, size_t height,
@@ -82,16 +185,137 @@ void block_database::store(std::shared_ptr<transaction_context> context,
     BITCOIN_ASSERT(height <= max_uint32);
     BITCOIN_ASSERT(!header.metadata.exists);
 
-    const auto writer = [&](byte_serializer& serial)
+    BITCOIN_ASSERT(chain::header::satoshi_fixed_size() ==
+        block_value::header::size);
+
+    block_value::record::type value;
+    auto serial = make_unsafe_serializer(block_value::header::data(
+        value.data()));
+    header.to_data(serial, false);
+    block_value::median_time_past::put(value.data(), median_time_past);
+    block_value::height::put(value.data(), static_cast<uint32_t>(height));
+
+    const auto hash = header.hash();
+    context->txn()->Put(block_handle_, to_slice(hash), to_slice(value));
+    update_state(context, hash, state, checksum);
+}
+
+bool block_database::update_transactions(
+    std::shared_ptr<transaction_context> context, const block& block)
+{
+    const auto& txs = block.transactions();
+    data_chunk value;
+    value.reserve(txs.size() * hash_size);
+
+    for (const auto& tx: txs)
     {
-        header.to_data(serial, false);
-        serial.write_4_bytes_little_endian(median_time_past);
-        serial.write_4_bytes_little_endian(static_cast<uint32_t>(height));
-        serial.write_byte(state);
-        serial.write_4_bytes_little_endian(checksum);
-    };
-    void* value = malloc(base_block_size);
-    //context->txn()->Put(block_handle_, header.hash(), value);
+        const auto hash = tx.hash();
+        value.insert(value.end(), hash.begin(), hash.end());
+    }
+
+    return context->txn()->Put(block_transactions_handle_,
+        to_slice(block.hash()), to_slice(value)).ok();
+}
+
+bool block_database::validate(std::shared_ptr<transaction_context> context,
+    const hash_digest& hash, const code& error)
+{
+    uint8_t current;
+    uint32_t checksum;
+    if (!read_state(context, hash, current, checksum))
+        return false;
+
+    const auto validation = error ? block_state::failed : block_state::valid;
+    const auto state = (current & ~block_state::validations) | validation;
+
+    return update_state(context, hash, static_cast<uint8_t>(state),
+        static_cast<uint32_t>(error.value()));
+}
+
+bool block_database::promote(std::shared_ptr<transaction_context> context,
+    const hash_digest& hash, size_t height, bool candidate)
+{
+    uint8_t current;
+    uint32_t checksum;
+    if (!read_state(context, hash, current, checksum))
+        return false;
+
+    const auto confirmation = candidate ? block_state::candidate :
+        block_state::confirmed;
+    const auto state = (current & ~block_state::confirmations) |
+        confirmation;
+
+    if (!update_state(context, hash, static_cast<uint8_t>(state), checksum))
+        return false;
+
+    return context->txn()->Put(block_index_handle_,
+        to_slice(index_key(height, candidate)), to_slice(hash)).ok();
+}
+
+bool block_database::demote(std::shared_ptr<transaction_context> context,
+    const hash_digest& hash, size_t height, bool candidate)
+{
+    uint8_t current;
+    uint32_t checksum;
+    if (!read_state(context, hash, current, checksum))
+        return false;
+
+    const auto confirmation = candidate ? block_state::candidate :
+        block_state::confirmed;
+    const auto state = current & ~confirmation;
+
+    if (!update_state(context, hash, static_cast<uint8_t>(state), checksum))
+        return false;
+
+    return context->txn()->Delete(block_index_handle_,
+        to_slice(index_key(height, candidate))).ok();
+}
+
+// private
+bool block_database::read_index(std::shared_ptr<reader> context,
+    size_t height, bool candidate, hash_digest& out_hash) const
+{
+    std::string value;
+    const auto status = context->get(block_index_handle_,
+        to_slice(index_key(height, candidate)), &value);
+
+    if (!status.ok() || value.size() != hash_size)
+        return false;
+
+    std::copy(value.begin(), value.end(), out_hash.begin());
+    return true;
+}
+
+// private
+bool block_database::read_state(std::shared_ptr<reader> context,
+    const hash_digest& hash, uint8_t& out_state,
+    uint32_t& out_checksum) const
+{
+    std::string value;
+    const auto status = context->get(block_state_handle_, to_slice(hash),
+        &value);
+
+    if (!status.ok() || value.size() != state_size)
+        return false;
+
+    const auto data = codec::to_bytes(value);
+    out_state = block_state_value::state::get(data);
+    out_checksum = block_state_value::checksum::get(data);
+    return true;
+}
+
+// private
+// State is a blind write of its own record, the header is not rewritten.
+bool block_database::update_state(
+    std::shared_ptr<transaction_context> context, const hash_digest& hash,
+    uint8_t state, uint32_t checksum)
+{
+    block_state_value::record::type value;
+    block_state_value::state::put(value.data(), state);
+    block_state_value::checksum::put(value.data(), checksum);
+
+    return context->txn()->Put(block_state_handle_, to_slice(hash),
+        to_slice(value)).ok();
 }
 
 } // namespace database
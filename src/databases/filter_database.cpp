@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/databases/filter_database.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/block_state.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include <bitcoin/database/slice.hpp>
+#include <bitcoin/database/result/filter_result.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/transaction.h"
+#include "rocksdb/utilities/optimistic_transaction_db.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+const uint8_t filter_database::basic_filter_type = 0x00;
+
+filter_database::filter_database(
+    std::shared_ptr<rocksdb::OptimisticTransactionDB> db_,
+    rocksdb::ColumnFamilyHandle* handle_, const block_database& blocks_)
+  : db_(db_), handle_(handle_), blocks_(blocks_)
+{
+}
+
+bool filter_database::compute(const block& block, data_chunk& out_filter)
+{
+    return neutrino::compute_filter(block, out_filter);
+}
+
+// Queries.
+// ----------------------------------------------------------------------------
+
+filter_result filter_database::get(std::shared_ptr<reader> context,
+    const hash_digest& block_hash) const
+{
+    std::string value;
+    const auto status = context->get(handle_, to_slice(block_hash), &value);
+
+    return status.ok() ? filter_result{ block_hash, to_chunk(value) } :
+        filter_result{};
+}
+
+// The block hashes are read as one index range and the filters as one batch.
+std::vector<filter_result> filter_database::get(
+    std::shared_ptr<reader> context, size_t start_height,
+    const hash_digest& stop_hash, size_t limit) const
+{
+    const auto stop = blocks_.get(context, stop_hash);
+    if (!stop || !is_confirmed(stop.state()) ||
+        stop.height() < start_height ||
+        stop.height() - start_height >= limit)
+        return {};
+
+    const auto hashes = blocks_.get_hashes(context, start_height,
+        stop.height(), false);
+
+    // The index changed since the stop block was read.
+    if (hashes.empty() || hashes.back() != stop_hash)
+        return {};
+
+    std::vector<rocksdb::Slice> keys;
+    keys.reserve(hashes.size());
+    for (const auto& hash: hashes)
+        keys.push_back(to_slice(hash));
+
+    std::vector<std::string> values;
+    const std::vector<rocksdb::ColumnFamilyHandle*> handles(hashes.size(),
+        handle_);
+    const auto statuses = context->multi_get(handles, keys, &values);
+
+    std::vector<filter_result> filters;
+    filters.reserve(hashes.size());
+
+    for (size_t index = 0; index < hashes.size(); ++index)
+    {
+        if (!statuses[index].ok())
+            return {};
+
+        filters.emplace_back(hashes[index], to_chunk(values[index]));
+    }
+
+    return filters;
+}
+
+// Writers.
+// ----------------------------------------------------------------------------
+
+bool filter_database::store(std::shared_ptr<transaction_context> context,
+    const header& header, const data_chunk& filter)
+{
+    // Genesis commits to the null filter header.
+    const auto& previous_hash = header.previous_block_hash();
+    auto previous_header = null_hash;
+
+    if (previous_hash != null_hash)
+    {
+        const auto previous = get(context, previous_hash);
+        if (!previous)
+            return false;
+
+        previous_header = previous.header();
+    }
+
+    data_chunk value(filter_prefix::record::size + filter.size());
+    filter_prefix::type::put(value.data(), basic_filter_type);
+    filter_prefix::header::put(value.data(),
+        neutrino::compute_filter_header(previous_header, filter));
+    std::copy(filter.begin(), filter.end(),
+        value.begin() + filter_prefix::record::size);
+
+    return context->txn()->Put(handle_, to_slice(header.hash()),
+        to_slice(value)).ok();
+}
+
+} // namespace database
+} // namespace libbitcoin
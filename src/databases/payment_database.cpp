@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/databases/payment_database.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include <bitcoin/database/slice.hpp>
+#include <bitcoin/database/result/payment_result.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/transaction.h"
+#include "rocksdb/utilities/optimistic_transaction_db.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+payment_database::payment_database(
+    std::shared_ptr<rocksdb::OptimisticTransactionDB> db_,
+    rocksdb::ColumnFamilyHandle* handle_)
+  : db_(db_), handle_(handle_)
+{
+}
+
+hash_digest payment_database::to_script_hash(const script& script)
+{
+    return sha256_hash(script.to_data(false));
+}
+
+// Queries.
+// ----------------------------------------------------------------------------
+
+// The family prefix extractor is the script hash, so seeks are bloom-filtered.
+payment_iterator payment_database::get(std::shared_ptr<reader> context,
+    const hash_digest& script_hash, const data_chunk& cursor,
+    size_t limit) const
+{
+    auto options = context->read_options();
+    options.prefix_same_as_start = true;
+
+    std::shared_ptr<rocksdb::Iterator> iterator(context->iterator(handle_,
+        options));
+
+    const auto resume = cursor.size() > hash_size &&
+        std::equal(script_hash.begin(), script_hash.end(), cursor.begin());
+
+    if (!resume)
+    {
+        iterator->Seek(to_slice(script_hash));
+        return { context, iterator, script_hash, limit };
+    }
+
+    // Skip the last payment of the previous page.
+    iterator->Seek(to_slice(cursor));
+    if (iterator->Valid() && iterator->key() == to_slice(cursor))
+        iterator->Next();
+
+    return { context, iterator, script_hash, limit };
+}
+
+// Every tx has an output, which is indexed with the other payments of the tx.
+bool payment_database::cataloged(std::shared_ptr<reader> context,
+    const transaction& tx, size_t height, size_t position) const
+{
+    const auto& outputs = tx.outputs();
+    if (outputs.empty())
+        return false;
+
+    const auto key = payment_result::to_key(
+        to_script_hash(outputs.front().script()), height, position, 0, true,
+        tx.hash());
+
+    std::string value;
+    return context->get(handle_, to_slice(key), &value).ok();
+}
+
+// Writers.
+// ----------------------------------------------------------------------------
+
+bool payment_database::catalog(std::shared_ptr<transaction_context> context,
+    const transaction& tx, size_t height, size_t position)
+{
+    for (const auto& row: to_rows(tx, height, position))
+        if (!context->txn()->Put(handle_, to_slice(row.first),
+            to_slice(to_value(row.second))).ok())
+            return false;
+
+    return true;
+}
+
+bool payment_database::uncatalog(std::shared_ptr<transaction_context> context,
+    const transaction& tx, size_t height, size_t position)
+{
+    for (const auto& row: to_rows(tx, height, position))
+        if (!context->txn()->Delete(handle_, to_slice(row.first)).ok())
+            return false;
+
+    return true;
+}
+
+payment_value::record::type payment_database::to_value(uint64_t value)
+{
+    payment_value::record::type data;
+    payment_value::value::put(data.data(), value);
+    return data;
+}
+
+payment_database::rows payment_database::to_rows(const transaction& tx,
+    size_t height, size_t position)
+{
+    const auto hash = tx.hash();
+    const auto& inputs = tx.inputs();
+    const auto& outputs = tx.outputs();
+
+    rows out;
+    out.reserve(inputs.size() + outputs.size());
+
+    for (uint32_t index = 0; index < outputs.size(); ++index)
+    {
+        const auto& output = outputs[index];
+        out.emplace_back(payment_result::to_key(
+            to_script_hash(output.script()), height, position, index, true,
+            hash), output.value());
+    }
+
+    // Spends are indexed under the script hash of the previous output.
+    if (!tx.is_coinbase())
+    {
+        for (uint32_t index = 0; index < inputs.size(); ++index)
+        {
+            const auto& prevout = inputs[index].previous_output().metadata;
+
+            if (!prevout.cache.is_valid())
+                continue;
+
+            out.emplace_back(payment_result::to_key(
+                to_script_hash(prevout.cache.script()), height, position,
+                index, false, hash), prevout.cache.value());
+        }
+    }
+
+    return out;
+}
+
+} // namespace database
+} // namespace libbitcoin
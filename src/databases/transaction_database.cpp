@@ -18,12 +18,25 @@
  */
 #include <bitcoin/database/databases/transaction_database.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
 #include <bitcoin/system.hpp>
+#include <bitcoin/database/codec.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include <bitcoin/database/pool_expiry_filter.hpp>
 #include <bitcoin/database/result/transaction_result.hpp>
+#include <bitcoin/database/slice.hpp>
+#include <bitcoin/database/transaction_record.hpp>
+#include <bitcoin/database/unspent_transaction.hpp>
 #include "rocksdb/db.h"
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
@@ -37,68 +50,602 @@ using namespace bc::system::machine;
 
 static constexpr auto no_time = 0u;
 
-// Transactions uses a hash table index, O(1).
+// Metadata is fixed size and stored inline (below any blob threshold).
+static constexpr auto metadata_size = metadata_value::record::size;
+
+// Pool records are prefixed by the time pooled and forks (then the body).
+static constexpr auto pool_prefix_size = pool_prefix::record::size;
+
+// Transactions are keyed by hash, O(log n).
 transaction_database::transaction_database(
     std::shared_ptr<rocksdb::OptimisticTransactionDB> db_,
     rocksdb::ColumnFamilyHandle* handle_,
-    size_t cache_capacity)
-  : db_(db_), handle_(handle_), cache_(cache_capacity)
-{
-}
-
-// // Store.
-// // ----------------------------------------------------------------------------
-
-// // Store new unconfirmed tx and set tx
-// bool transaction_database::store(const chain::transaction& tx, uint32_t forks)
-// {
-//     // Cache the unspent outputs of the unconfirmed transaction.
-//     cache_.add(tx, forks, no_time, false);
-
-//     return storize(tx, forks, no_time, transaction_result::unconfirmed);
-// }
-
-// // private
-// bool transaction_database::storize(const chain::transaction& tx, size_t height,
-//     uint32_t median_time_past, size_t position)
-// {
-//     BITCOIN_ASSERT(height <= max_uint32);
-//     BITCOIN_ASSERT(position <= max_uint16);
-
-//     // Assume the caller has not tested for existence (true for block update).
-//     if (tx.metadata.link == transaction::validation::unlinked)
-//     {
-//         const auto element = hash_table_.find(tx.hash());
-
-//         if (element)
-//             tx.metadata.link = element.link();
-//     }
-
-//     // This allows address indexer to bypass indexing despite link existence.
-//     tx.metadata.existed = tx.metadata.link != transaction::validation::unlinked;
-
-//     // If the transaction already exists just return (with link set).
-//     if (tx.metadata.existed)
-//         return true;
-
-//     const auto writer = [&](byte_serializer& serial)
-//     {
-//         serial.write_4_bytes_little_endian(static_cast<uint32_t>(height));
-//         serial.write_2_bytes_little_endian(static_cast<uint16_t>(position));
-//         serial.write_byte(transaction_result::candidate_false);
-//         serial.write_4_bytes_little_endian(median_time_past);
-//         tx.to_data(serial, false, true);
-//     };
-
-//     // Transactions are variable-sized.
-//     const auto size = metadata_size + tx.serialized_size(false, true);
-
-//     // Write the new transaction.
-//     auto next = hash_table_.allocator();
-//     tx.metadata.link = next.create(tx.hash(), writer, size);
-//     hash_table_.link(next);
-//     return true;
-// }
+    rocksdb::ColumnFamilyHandle* metadata_handle_,
+    rocksdb::ColumnFamilyHandle* pool_handle_, size_t cache_capacity,
+    size_t cache_spent_window, uint32_t pool_expiry, size_t pool_capacity,
+    perf_stats& stats)
+  : db_(db_), handle_(handle_), metadata_handle_(metadata_handle_),
+    pool_handle_(pool_handle_), pool_expiry_(pool_expiry),
+    cache_(cache_capacity, cache_spent_window),
+    pool_(pool_expiry, pool_capacity),
+    stats_(stats)
+{
+}
+
+// Queries.
+// ----------------------------------------------------------------------------
+
+// Only metadata is read here, the body is read by the result on demand.
+// A pooled tx has no metadata, its body is read with the result.
+transaction_result transaction_database::get(std::shared_ptr<reader> context,
+    const hash_digest& hash) const
+{
+    metadata value;
+    if (!read_metadata(context, hash, value))
+    {
+        uint32_t forks;
+        data_chunk body;
+        return read_pool(context, hash, forks, body) ?
+            transaction_result{ hash, forks, body } : transaction_result{};
+    }
+
+    return
+    {
+        context, handle_, hash, value.height, value.position,
+        value.candidate, value.median_time_past
+    };
+}
+
+// Metadata and bodies are each read in one batch, so that the reads of a
+// block overlap. A tx without metadata (pooled) is read alone.
+transaction::list transaction_database::get(std::shared_ptr<reader> context,
+    const hash_list& hashes) const
+{
+    std::vector<rocksdb::Slice> keys;
+    keys.reserve(hashes.size());
+    for (const auto& hash: hashes)
+        keys.push_back(to_slice(hash));
+
+    std::vector<std::string> values;
+    const std::vector<rocksdb::ColumnFamilyHandle*> metadata_handles(
+        keys.size(), metadata_handle_);
+    const auto statuses = context->multi_get(metadata_handles, keys,
+        &values);
+
+    std::vector<size_t> found_index;
+    std::vector<rocksdb::Slice> body_keys;
+    found_index.reserve(keys.size());
+    body_keys.reserve(keys.size());
+
+    for (size_t index = 0; index < keys.size(); ++index)
+    {
+        metadata value;
+        if (statuses[index].ok() && to_metadata(values[index], value))
+        {
+            found_index.push_back(index);
+            body_keys.push_back(keys[index]);
+        }
+    }
+
+    std::vector<std::string> bodies;
+    const std::vector<rocksdb::ColumnFamilyHandle*> body_handles(
+        body_keys.size(), handle_);
+    const auto body_statuses = context->multi_get(body_handles, body_keys,
+        &bodies);
+
+    transaction::list txs(hashes.size());
+    std::vector<bool> read(hashes.size(), false);
+
+    for (size_t index = 0; index < body_keys.size(); ++index)
+    {
+        // A missing tx invalidates the whole set.
+        if (!body_statuses[index].ok())
+            return {};
+
+        // As does a pruned tx (which is invalid).
+        const auto body = to_chunk(bodies[index]);
+        if (transaction_record::is_pruned(body))
+            return {};
+
+        auto& tx = txs[found_index[index]];
+        tx = transaction_record::factory(body);
+        if (!tx.is_valid())
+            return {};
+
+        read[found_index[index]] = true;
+    }
+
+    for (size_t index = 0; index < hashes.size(); ++index)
+    {
+        if (read[index])
+            continue;
+
+        const auto result = get(context, hashes[index]);
+        if (!result)
+            return {};
+
+        txs[index] = result.transaction();
+        if (!txs[index].is_valid())
+            return {};
+    }
+
+    return txs;
+}
+
+bool transaction_database::get_output(std::shared_ptr<reader> context,
+    const output_point& point, size_t fork_height) const
+{
+    auto& prevout = point.metadata;
+    prevout.reset();
+
+    if (point.is_null())
+        return false;
+
+    // Cache does not contain spent outputs or indexed-block transactions.
+    if (cache_.populate(point, fork_height))
+        return true;
+
+    // Only store reads are sampled, cache hits are in the cache hit rate.
+    const perf_stats::sample sample(stats_, perf_stats::get_output);
+    const auto result = get(context, point.hash());
+
+    if (!result)
+        return false;
+
+    const auto height = result.height();
+    const auto position = result.position();
+    const auto confirmed = position != transaction_result::unconfirmed &&
+        position != transaction_result::deconfirmed;
+
+    prevout.candidate = result.candidate();
+    prevout.confirmed = confirmed && height <= fork_height;
+    prevout.height = height;
+    prevout.coinbase = confirmed && position == 0;
+    prevout.median_time_past = result.median_time_past();
+    prevout.cache = result.output(point.index());
+    return prevout.cache.is_valid();
+}
+
+void transaction_database::get_prevouts(std::shared_ptr<reader> context,
+    const transaction& tx, size_t fork_height) const
+{
+    if (tx.is_coinbase())
+        return;
+
+    for (const auto& input: tx.inputs())
+        if (!input.previous_output().metadata.cache.is_valid())
+            get_output(context, input.previous_output(), fork_height);
+}
+
+// Bodies are read in key order, so a scan reads each table (and blob) file
+// sequentially, with the readahead of the context.
+bool transaction_database::scan(std::shared_ptr<reader> context,
+    visitor handler) const
+{
+    const std::unique_ptr<rocksdb::Iterator> iterator(context->iterator(
+        handle_, context->read_options()));
+
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next())
+    {
+        const auto body = to_chunk(iterator->value().ToString());
+
+        // Pruned records are not transactions.
+        if (transaction_record::is_pruned(body))
+            continue;
+
+        const auto tx = transaction_record::factory(body);
+        if (!tx.is_valid() || !handler(tx))
+            return false;
+    }
+
+    return iterator->status().ok();
+}
+
+// Expired records that are not yet compacted away are skipped.
+bool transaction_database::scan_pool(std::shared_ptr<reader> context,
+    visitor handler) const
+{
+    const auto now = pool_expiry_filter::now();
+
+    if (pool_handle_ == nullptr)
+    {
+        for (const auto& body: pool_.bodies(now))
+            if (!handler(transaction_record::factory(body)))
+                return false;
+
+        return true;
+    }
+
+    const std::unique_ptr<rocksdb::Iterator> iterator(context->iterator(
+        pool_handle_, context->read_options()));
+
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next())
+    {
+        const auto value = iterator->value();
+        if (value.size() <= pool_prefix_size ||
+            uint64_t{ pool_expiry_filter::pooled_time(value) } +
+                pool_expiry_ <= now)
+            continue;
+
+        const auto data = codec::to_bytes(value);
+        const auto tx = transaction_record::factory(
+            { data + pool_prefix_size, data + value.size() });
+
+        if (!tx.is_valid() || !handler(tx))
+            return false;
+    }
+
+    return iterator->status().ok();
+}
+
+// Cache.
+// ----------------------------------------------------------------------------
+
+// Metadata and bodies are each read in one batch. Only the spent outputs are
+// cached, as the rest of each previous tx is not needed by the block.
+size_t transaction_database::prefetch(std::shared_ptr<reader> context,
+    const block& block)
+{
+    if (cache_.disabled())
+        return 0;
+
+    // Group the spent output indexes by previous tx.
+    std::unordered_map<hash_digest, std::vector<uint32_t>,
+        boost::hash<hash_digest>> spends;
+
+    for (const auto& tx: block.transactions())
+        if (!tx.is_coinbase())
+            for (const auto& input: tx.inputs())
+                spends[input.previous_output().hash()].push_back(
+                    input.previous_output().index());
+
+    // Spends within the block are not stored.
+    for (const auto& tx: block.transactions())
+        spends.erase(tx.hash());
+
+    if (spends.empty())
+        return 0;
+
+    hash_list hashes;
+    hashes.reserve(spends.size());
+    for (const auto& spend: spends)
+        hashes.push_back(spend.first);
+
+    std::vector<rocksdb::Slice> keys;
+    keys.reserve(hashes.size());
+    for (const auto& hash: hashes)
+        keys.push_back(to_slice(hash));
+
+    std::vector<std::string> values;
+    const std::vector<rocksdb::ColumnFamilyHandle*> metadata_handles(
+        keys.size(), metadata_handle_);
+    const auto statuses = context->multi_get(metadata_handles, keys,
+        &values);
+
+    // Pooled txs are cached when stored, so only block txs are read.
+    std::vector<metadata> found;
+    std::vector<size_t> found_index;
+    std::vector<rocksdb::Slice> body_keys;
+
+    for (size_t index = 0; index < keys.size(); ++index)
+    {
+        metadata value;
+        if (!statuses[index].ok() || !to_metadata(values[index], value))
+            continue;
+
+        found.push_back(value);
+        found_index.push_back(index);
+        body_keys.push_back(keys[index]);
+    }
+
+    std::vector<std::string> bodies;
+    const std::vector<rocksdb::ColumnFamilyHandle*> body_handles(
+        body_keys.size(), handle_);
+    const auto body_statuses = context->multi_get(body_handles, body_keys,
+        &bodies);
+
+    size_t cached = 0;
+    for (size_t index = 0; index < body_keys.size(); ++index)
+    {
+        if (!body_statuses[index].ok())
+            continue;
+
+        const auto tx = transaction_record::factory(to_chunk(bodies[index]),
+            false);
+        const auto& outputs = tx.outputs();
+        const auto& value = found[index];
+        const auto& hash = hashes[found_index[index]];
+        const auto confirmed = value.position !=
+            transaction_result::unconfirmed && value.position !=
+            transaction_result::deconfirmed;
+
+        unspent_transaction unspent(hash, value.height,
+            value.median_time_past, confirmed && value.position == 0,
+            confirmed);
+
+        for (const auto point: spends[hash])
+            if (point < outputs.size())
+                (*unspent.outputs())[point] = outputs[point];
+
+        cache_.add(std::move(unspent));
+        ++cached;
+    }
+
+    return cached;
+}
+
+// Store.
+// ----------------------------------------------------------------------------
+
+// Pool new unconfirmed tx, a tx already stored or pooled is not rewritten.
+bool transaction_database::store(std::shared_ptr<transaction_context> context,
+    const transaction& tx, uint32_t forks)
+{
+    // Cache the unspent outputs of the unconfirmed transaction.
+    cache_.add(tx, forks, no_time, false);
+
+    const auto hash = tx.hash();
+    metadata existing;
+    uint32_t pooled_forks;
+    data_chunk pooled_body;
+
+    // This allows address indexer to bypass indexing despite existence.
+    tx.metadata.existed = read_metadata(context, hash, existing) ||
+        read_pool(context, hash, pooled_forks, pooled_body);
+
+    return tx.metadata.existed || write_pool(context, tx, forks);
+}
+
+// Store each new tx of the unconfirmed block and set tx link metadata for all.
+bool transaction_database::store(std::shared_ptr<transaction_context> context,
+    const transaction::list& transactions)
+{
+    for (const auto& tx: transactions)
+        if (!storize(context, tx, transaction_result::unverified, no_time,
+            transaction_result::unconfirmed))
+            return false;
+
+    return true;
+}
+
+// private
+bool transaction_database::storize(
+    std::shared_ptr<transaction_context> context, const transaction& tx,
+    size_t height, uint32_t median_time_past, size_t position)
+{
+    BITCOIN_ASSERT(height <= max_uint32);
+    BITCOIN_ASSERT(position <= max_uint16);
+
+    const auto hash = tx.hash();
+    metadata existing;
+
+    // This allows address indexer to bypass indexing despite existence.
+    tx.metadata.existed = read_metadata(context, hash, existing);
+
+    // If the transaction already exists just return.
+    if (tx.metadata.existed)
+        return true;
+
+    // The body is written once and never rewritten by metadata updates.
+    const auto body = transaction_record::to_data(tx);
+    const auto status = context->txn()->Put(handle_, to_slice(hash),
+        to_slice(body));
+
+    if (!status.ok())
+        return false;
+
+    // A pooled tx is moved once in a block.
+    return unpool(context, hash) && write_metadata(context, hash,
+    {
+        static_cast<uint32_t>(height),
+        static_cast<uint16_t>(position),
+        false,
+        median_time_past
+    });
+}
+
+// Pool.
+// ----------------------------------------------------------------------------
+// private
+
+// Expired records are not found, though not removed until compaction.
+bool transaction_database::read_pool(std::shared_ptr<reader> context,
+    const hash_digest& hash, uint32_t& out_forks, data_chunk& out_body) const
+{
+    const auto now = pool_expiry_filter::now();
+
+    if (pool_handle_ == nullptr)
+        return pool_.find(hash, out_forks, out_body, now);
+
+    std::string value;
+    const auto status = context->get(pool_handle_, to_slice(hash), &value);
+
+    if (!status.ok() || value.size() <= pool_prefix_size ||
+        uint64_t{ pool_expiry_filter::pooled_time(value) } + pool_expiry_ <=
+            now)
+        return false;
+
+    const auto data = codec::to_bytes(value);
+    out_forks = pool_prefix::forks::get(data);
+    out_body.assign(data + pool_prefix_size, data + value.size());
+    return true;
+}
+
+bool transaction_database::write_pool(
+    std::shared_ptr<transaction_context> context, const transaction& tx,
+    uint32_t forks)
+{
+    const auto now = pool_expiry_filter::now();
+    const auto body = transaction_record::to_data(tx);
+
+    if (pool_handle_ == nullptr)
+    {
+        pool_.add(tx.hash(), forks, body, now);
+        return true;
+    }
+
+    data_chunk value(pool_prefix_size + body.size());
+    pool_prefix::time::put(value.data(), now);
+    pool_prefix::forks::put(value.data(), forks);
+    std::copy(body.begin(), body.end(), value.begin() + pool_prefix_size);
+
+    return context->txn()->Put(pool_handle_, to_slice(tx.hash()),
+        to_slice(value)).ok();
+}
+
+// Only pooled txs are deleted, so block txs do not write tombstones.
+bool transaction_database::unpool(
+    std::shared_ptr<transaction_context> context, const hash_digest& hash)
+{
+    if (pool_handle_ == nullptr)
+    {
+        pool_.remove(hash);
+        return true;
+    }
+
+    std::string value;
+    const auto status = context->get(pool_handle_, to_slice(hash), &value);
+
+    if (status.IsNotFound())
+        return true;
+
+    return status.ok() &&
+        context->txn()->Delete(pool_handle_, to_slice(hash)).ok();
+}
+
+// Candidate.
+// ----------------------------------------------------------------------------
+
+bool transaction_database::candidate(
+    std::shared_ptr<transaction_context> context, const hash_digest& hash)
+{
+    return candidize(context, hash, true);
+}
+
+bool transaction_database::uncandidate(
+    std::shared_ptr<transaction_context> context, const hash_digest& hash)
+{
+    return candidize(context, hash, false);
+}
+
+// private
+bool transaction_database::candidize(
+    std::shared_ptr<transaction_context> context, const hash_digest& hash,
+    bool positive)
+{
+    metadata value;
+    if (!read_metadata(context, hash, value))
+        return false;
+
+    value.candidate = positive;
+    return write_metadata(context, hash, value);
+}
+
+// Confirm.
+// ----------------------------------------------------------------------------
+
+bool transaction_database::confirm(
+    std::shared_ptr<transaction_context> context, const hash_digest& hash,
+    size_t height, uint32_t median_time_past, size_t position)
+{
+    return confirmize(context, hash, height, median_time_past, position);
+}
+
+bool transaction_database::confirm(
+    std::shared_ptr<transaction_context> context, const block& block,
+    size_t height, uint32_t median_time_past)
+{
+    BITCOIN_ASSERT(height <= max_uint32);
+    const auto& txs = block.transactions();
+
+    for (size_t position = 0; position < txs.size(); ++position)
+        if (!confirmize(context, txs[position].hash(), height,
+            median_time_past, position))
+            return false;
+
+    // Txs cached from the pool are promoted and spends are marked, under
+    // one cache lock.
+    cache_.apply(block, height, median_time_past);
+    return true;
+}
+
+bool transaction_database::unconfirm(
+    std::shared_ptr<transaction_context> context, const block& block)
+{
+    for (const auto& tx: block.transactions())
+        if (!confirmize(context, tx.hash(), transaction_result::unverified,
+            no_time, transaction_result::deconfirmed))
+            return false;
+
+    // Cached txs are rolled back, under one cache lock.
+    cache_.revert(block);
+    return true;
+}
+
+// private
+bool transaction_database::confirmize(
+    std::shared_ptr<transaction_context> context, const hash_digest& hash,
+    size_t height, uint32_t median_time_past, size_t position)
+{
+    BITCOIN_ASSERT(height <= max_uint32);
+    BITCOIN_ASSERT(position <= max_uint16);
+
+    metadata value;
+    if (!read_metadata(context, hash, value))
+        return false;
+
+    value.height = static_cast<uint32_t>(height);
+    value.position = static_cast<uint16_t>(position);
+    value.median_time_past = median_time_past;
+    return write_metadata(context, hash, value);
+}
+
+// Metadata.
+// ----------------------------------------------------------------------------
+// private
+
+bool transaction_database::read_metadata(std::shared_ptr<reader> context,
+    const hash_digest& hash, metadata& out_metadata) const
+{
+    std::string value;
+    const auto status = context->get(metadata_handle_, to_slice(hash),
+        &value);
+
+    return status.ok() && to_metadata(value, out_metadata);
+}
+
+bool transaction_database::to_metadata(const std::string& value,
+    metadata& out_metadata)
+{
+    if (value.size() != metadata_size)
+        return false;
+
+    const auto data = codec::to_bytes(value);
+    out_metadata.height = metadata_value::height::get(data);
+    out_metadata.position = metadata_value::position::get(data);
+    out_metadata.candidate = metadata_value::candidate::get(data) ==
+        transaction_result::candidate_true;
+    out_metadata.median_time_past =
+        metadata_value::median_time_past::get(data);
+    return true;
+}
+
+bool transaction_database::write_metadata(
+    std::shared_ptr<transaction_context> context, const hash_digest& hash,
+    const metadata& value)
+{
+    metadata_value::record::type data;
+    metadata_value::height::put(data.data(), value.height);
+    metadata_value::position::put(data.data(), value.position);
+    metadata_value::candidate::put(data.data(), value.candidate ?
+        transaction_result::candidate_true :
+        transaction_result::candidate_false);
+    metadata_value::median_time_past::put(data.data(),
+        value.median_time_past);
+
+    return context->txn()->Put(metadata_handle_, to_slice(hash),
+        to_slice(data)).ok();
+}
 
 } // namespace database
 } // namespace libbitcoin
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/memory_pool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/system.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+
+// Approximate heap overhead of an entry, in addition to its stored tx.
+static constexpr size_t entry_overhead = 128;
+
+memory_pool::memory_pool(uint32_t expiry, size_t capacity)
+  : expiry_(expiry), capacity_(capacity), bytes_(0)
+{
+}
+
+// private
+size_t memory_pool::entry_bytes(const data_chunk& body)
+{
+    return entry_overhead + body.size();
+}
+
+size_t memory_pool::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return pool_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t memory_pool::bytes() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return bytes_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void memory_pool::add(const hash_digest& hash, uint32_t forks,
+    const data_chunk& body, uint32_t time)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Remove expired entries, oldest first.
+    while (!pool_.empty() &&
+        uint64_t{ pool_.right.begin()->first } + expiry_ <= time)
+    {
+        bytes_ -= entry_bytes(pool_.right.begin()->info.body);
+        pool_.right.erase(pool_.right.begin());
+    }
+
+    // An existing entry (with its time) is retained.
+    if (pool_.insert(pooled_transactions::value_type(hash, time,
+        entry{ forks, body })).second)
+        bytes_ += entry_bytes(body);
+
+    // Evict the oldest entries while over capacity.
+    while (!pool_.empty() && bytes_ > capacity_)
+    {
+        bytes_ -= entry_bytes(pool_.right.begin()->info.body);
+        pool_.right.erase(pool_.right.begin());
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void memory_pool::remove(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    const auto it = pool_.left.find(hash);
+    if (it == pool_.left.end())
+        return;
+
+    bytes_ -= entry_bytes(it->info.body);
+    pool_.left.erase(it);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool memory_pool::find(const hash_digest& hash, uint32_t& out_forks,
+    data_chunk& out_body, uint32_t time) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    const auto it = pool_.left.find(hash);
+    if (it == pool_.left.end() || uint64_t{ it->second } + expiry_ <= time)
+        return false;
+
+    out_forks = it->info.forks;
+    out_body = it->info.body;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+data_stack memory_pool::bodies(uint32_t time) const
+{
+    data_stack out;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    out.reserve(pool_.size());
+    for (const auto& pooled: pool_.left)
+        if (uint64_t{ pooled.second } + expiry_ > time)
+            out.push_back(pooled.info.body);
+
+    return out;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/perf_stats.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <bitcoin/system.hpp>
+#include "rocksdb/iostats_context.h"
+#include "rocksdb/perf_context.h"
+#include "rocksdb/perf_level.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+using namespace std::chrono;
+
+constexpr size_t perf_stats::operations;
+
+static const char* operation_names[perf_stats::operations]
+{
+    "commit",
+    "get_output",
+    "get_block"
+};
+
+// Perf contexts are per thread, so a sample owns its thread's contexts.
+static thread_local bool sampling = false;
+
+// Sample.
+// ----------------------------------------------------------------------------
+
+perf_stats::sample::sample(perf_stats& stats, operation op)
+  : stats_(stats),
+    operation_(op),
+    sampled_(stats.begin(op) && !sampling),
+    level_(rocksdb::PerfLevel::kDisable)
+{
+    if (!sampled_)
+        return;
+
+    sampling = true;
+    level_ = rocksdb::GetPerfLevel();
+    rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeExceptForMutex);
+    rocksdb::get_perf_context()->Reset();
+    rocksdb::get_iostats_context()->Reset();
+    start_ = steady_clock::now();
+}
+
+perf_stats::sample::~sample()
+{
+    if (!sampled_)
+        return;
+
+    const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() -
+        start_).count();
+
+    stats_.end(operation_, static_cast<uint64_t>(elapsed));
+    rocksdb::SetPerfLevel(level_);
+    sampling = false;
+}
+
+// Stats.
+// ----------------------------------------------------------------------------
+
+perf_stats::perf_stats(size_t rate, uint32_t log_interval_seconds)
+  : rate_(rate),
+    log_interval_(log_interval_seconds),
+    totals_(),
+    logged_(steady_clock::now())
+{
+    for (auto& calls: calls_)
+        calls = 0;
+}
+
+bool perf_stats::enabled() const
+{
+    return rate_ != 0;
+}
+
+perf_stats::totals perf_stats::get(operation op) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    auto out = totals_[op];
+    out.calls = calls_[op];
+    return out;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+std::string perf_stats::to_string() const
+{
+    std::ostringstream out;
+
+    for (size_t op = 0; op < operations; ++op)
+    {
+        const auto totals = get(static_cast<operation>(op));
+        const auto samples = totals.samples == 0 ? 1 : totals.samples;
+
+        out << operation_names[op]
+            << ": calls " << totals.calls
+            << ", samples " << totals.samples
+            << ", avg us " << totals.elapsed_nanoseconds / samples / 1000
+            << ", cache hits " << totals.block_cache_hits
+            << ", block reads " << totals.block_reads
+            << ", block bytes " << totals.block_read_bytes
+            << ", bloom hits " << totals.bloom_filter_hits
+            << ", bloom misses " << totals.bloom_filter_misses
+            << ", memtable reads " << totals.memtable_reads
+            << ", stall us " << totals.write_stall_nanoseconds / 1000
+            << ", wal us " << totals.wal_write_nanoseconds / 1000
+            << ", memtable us " << totals.memtable_write_nanoseconds / 1000
+            << ", io read " << totals.io_read_bytes
+            << ", io write " << totals.io_write_bytes
+            << ", fsync us " << totals.fsync_nanoseconds / 1000
+            << std::endl;
+    }
+
+    return out.str();
+}
+
+// private
+bool perf_stats::begin(operation op)
+{
+    const auto calls = ++calls_[op];
+    return rate_ != 0 && calls % rate_ == 0;
+}
+
+// private
+void perf_stats::end(operation op, uint64_t elapsed_nanoseconds)
+{
+    const auto& perf = *rocksdb::get_perf_context();
+    const auto& io = *rocksdb::get_iostats_context();
+    auto log = false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    auto& totals = totals_[op];
+    ++totals.samples;
+    totals.elapsed_nanoseconds += elapsed_nanoseconds;
+    totals.block_cache_hits += perf.block_cache_hit_count;
+    totals.block_reads += perf.block_read_count;
+    totals.block_read_bytes += perf.block_read_byte;
+    totals.bloom_filter_hits += perf.bloom_sst_hit_count;
+    totals.bloom_filter_misses += perf.bloom_sst_miss_count;
+    totals.memtable_reads += perf.get_from_memtable_count;
+    totals.write_stall_nanoseconds += perf.write_delay_time;
+    totals.wal_write_nanoseconds += perf.write_wal_time;
+    totals.memtable_write_nanoseconds += perf.write_memtable_time;
+    totals.io_read_bytes += io.bytes_read;
+    totals.io_write_bytes += io.bytes_written;
+    totals.fsync_nanoseconds += io.fsync_nanos;
+
+    const auto now = steady_clock::now();
+    if (log_interval_.count() != 0 && now - logged_ >= log_interval_)
+    {
+        logged_ = now;
+        log = true;
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (log)
+        LOG_INFO(LOG_DATABASE) << "Store operations (sampled):" << std::endl
+            << to_string();
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/pool_expiry_filter.hpp>
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/codec.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/slice.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+
+pool_expiry_filter::pool_expiry_filter(uint32_t expiry)
+  : expiry_(expiry)
+{
+}
+
+uint32_t pool_expiry_filter::pooled_time(const rocksdb::Slice& value)
+{
+    if (value.size() < pool_prefix::time::end)
+        return 0;
+
+    return pool_prefix::time::get(codec::to_bytes(value));
+}
+
+uint32_t pool_expiry_filter::now()
+{
+    return static_cast<uint32_t>(std::time(nullptr));
+}
+
+// Malformed records have time zero, so are also dropped.
+bool pool_expiry_filter::Filter(int, const rocksdb::Slice&,
+    const rocksdb::Slice& existing_value, std::string*, bool*) const
+{
+    return pooled_time(existing_value) + uint64_t{ expiry_ } <= now();
+}
+
+const char* pool_expiry_filter::Name() const
+{
+    return "libbitcoin.pool_expiry_filter";
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/prune_filter.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/codec.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include <bitcoin/database/result/transaction_result.hpp>
+#include <bitcoin/database/slice.hpp>
+#include <bitcoin/database/transaction_record.hpp>
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/db.h"
+#include "rocksdb/slice.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+
+// Filters one compaction with the state of the prune filter.
+class prune_filter::compaction
+  : public rocksdb::CompactionFilter
+{
+public:
+    compaction(const prune_filter& filter)
+      : filter_(filter)
+    {
+    }
+
+    bool Filter(int, const rocksdb::Slice& key,
+        const rocksdb::Slice& existing_value, std::string* new_value,
+        bool* value_changed) const override
+    {
+        return filter_.filter(key, existing_value, new_value, value_changed);
+    }
+
+    const char* Name() const override
+    {
+        return filter_.Name();
+    }
+
+private:
+    const prune_filter& filter_;
+};
+
+prune_filter::prune_filter(family records)
+  : family_(records), height_(0), db_(nullptr), blocks_handle_(nullptr),
+    metadata_handle_(nullptr)
+{
+}
+
+void prune_filter::open(rocksdb::DB* db,
+    rocksdb::ColumnFamilyHandle* blocks_handle,
+    rocksdb::ColumnFamilyHandle* metadata_handle)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    db_ = db;
+    blocks_handle_ = blocks_handle;
+    metadata_handle_ = metadata_handle;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void prune_filter::close()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    db_ = nullptr;
+    blocks_handle_ = nullptr;
+    metadata_handle_ = nullptr;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t prune_filter::height() const
+{
+    return height_;
+}
+
+void prune_filter::set_height(size_t height)
+{
+    height_ = height;
+}
+
+// private
+// Heights are read from families that this filter does not compact.
+bool prune_filter::read(const rocksdb::Slice& key, std::string& value) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    const auto handle = family_ == family::transactions ? metadata_handle_ :
+        blocks_handle_;
+
+    // Compaction reads each height once, so does not displace cached blocks.
+    rocksdb::ReadOptions options;
+    options.fill_cache = false;
+
+    return db_ != nullptr && db_->Get(options, handle, key, &value).ok();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Only confirmed txs are pruned, as a pooled or deconfirmed tx may be
+// confirmed again.
+bool prune_filter::prunable(const rocksdb::Slice& key) const
+{
+    const size_t height = height_;
+    std::string value;
+
+    if (height == 0 || !read(key, value))
+        return false;
+
+    if (family_ != family::transactions)
+        return value.size() == block_value::record::size &&
+            block_value::height::get(codec::to_bytes(value)) < height;
+
+    if (value.size() != metadata_value::record::size)
+        return false;
+
+    const auto data = codec::to_bytes(value);
+    const auto position = metadata_value::position::get(data);
+    return position != transaction_result::unconfirmed &&
+        position != transaction_result::deconfirmed &&
+        metadata_value::height::get(data) < height;
+}
+
+// Pruned tx bodies are rewritten once, as pruned records are not pruned.
+bool prune_filter::filter(const rocksdb::Slice& key,
+    const rocksdb::Slice& existing_value, std::string* new_value,
+    bool* value_changed) const
+{
+    if (family_ != family::transactions)
+        return prunable(key);
+
+    const auto body = to_chunk(existing_value.ToString());
+    if (transaction_record::is_pruned(body) || !prunable(key))
+        return false;
+
+    const auto pruned = transaction_record::to_pruned(body);
+    if (pruned.empty())
+        return false;
+
+    new_value->assign(pruned.begin(), pruned.end());
+    *value_changed = true;
+    return false;
+}
+
+std::unique_ptr<rocksdb::CompactionFilter>
+prune_filter::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& context)
+{
+    if (!context.is_bottommost_level || height_ == 0)
+        return nullptr;
+
+    return std::unique_ptr<rocksdb::CompactionFilter>(new compaction(*this));
+}
+
+const char* prune_filter::Name() const
+{
+    return "libbitcoin.prune_filter";
+}
+
+} // namespace database
+} // namespace libbitcoin
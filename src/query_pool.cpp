@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/query_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace libbitcoin {
+namespace database {
+
+query_pool::query_pool(size_t threads, size_t maximum_in_flight)
+  : maximum_in_flight_(maximum_in_flight), stopped_(false), running_(0)
+{
+    threads = std::max(threads, size_t{ 1 });
+    threads_.reserve(threads);
+
+    for (size_t thread = 0; thread < threads; ++thread)
+        threads_.emplace_back(&query_pool::run, this);
+}
+
+query_pool::~query_pool()
+{
+    stop();
+}
+
+size_t query_pool::in_flight() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return queue_.size() + running_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool query_pool::post(task&& query)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (stopped_ || queue_.size() + running_ >= maximum_in_flight_)
+            return false;
+
+        queue_.push(std::move(query));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    condition_.notify_one();
+    return true;
+}
+
+void query_pool::stop()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    condition_.notify_all();
+
+    for (auto& thread: threads_)
+        if (thread.joinable())
+            thread.join();
+}
+
+// private
+void query_pool::run()
+{
+    while (true)
+    {
+        task query;
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]()
+            {
+                return stopped_ || !queue_.empty();
+            });
+
+            // Queued tasks are run after stop, so that handlers are called.
+            if (queue_.empty())
+                return;
+
+            query = std::move(queue_.front());
+            queue_.pop();
+            ++running_;
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        query();
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running_;
+        }
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/read_view.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/optimistic_transaction_db.h"
+
+namespace libbitcoin {
+namespace database {
+
+read_view::read_view(std::shared_ptr<rocksdb::OptimisticTransactionDB> db,
+    bool fill_cache, size_t readahead)
+  : db_(db), snapshot_(db->GetSnapshot())
+{
+    options_.snapshot = snapshot_;
+    options_.fill_cache = fill_cache;
+    options_.readahead_size = readahead;
+
+    // Automatic readahead carries over from one table file to the next.
+    options_.adaptive_readahead = readahead == 0;
+}
+
+read_view::~read_view()
+{
+    db_->ReleaseSnapshot(snapshot_);
+}
+
+rocksdb::ReadOptions read_view::read_options() const
+{
+    return options_;
+}
+
+rocksdb::Status read_view::get(rocksdb::ColumnFamilyHandle* handle,
+    const rocksdb::Slice& key, std::string* value) const
+{
+    return db_->Get(options_, handle, key, value);
+}
+
+std::vector<rocksdb::Status> read_view::multi_get(
+    const std::vector<rocksdb::ColumnFamilyHandle*>& handles,
+    const std::vector<rocksdb::Slice>& keys,
+    std::vector<std::string>* values) const
+{
+    return db_->MultiGet(options_, handles, keys, values);
+}
+
+rocksdb::Iterator* read_view::iterator(rocksdb::ColumnFamilyHandle* handle,
+    const rocksdb::ReadOptions& options) const
+{
+    return db_->NewIterator(options, handle);
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,222 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/result/block_iterator.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/query_pool.hpp>
+#include <bitcoin/database/databases/block_database.hpp>
+#include <bitcoin/database/databases/transaction_database.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+// A block read, run once by whichever of a pool thread or the iterating
+// thread starts it first.
+class block_iterator::read
+{
+public:
+    read(std::shared_ptr<read_view> view, const block_database& blocks,
+        const transaction_database& transactions, const hash_digest& hash)
+      : view_(view), blocks_(blocks), transactions_(transactions),
+        hash_(hash), started_(false), future_(promise_.get_future())
+    {
+    }
+
+    // Read the block unless started, false if started.
+    bool run()
+    {
+        if (started_.exchange(true))
+            return false;
+
+        const auto result = blocks_.get(view_, hash_);
+        promise_.set_value(!result ? block{} : block(result.header(),
+            transactions_.get(view_, result.transaction_hashes())));
+        return true;
+    }
+
+    // Prevent the read from starting, false if started.
+    bool abandon()
+    {
+        return !started_.exchange(true);
+    }
+
+    // Read the block unless started, otherwise wait for it.
+    block get()
+    {
+        run();
+        return future_.get();
+    }
+
+private:
+    const std::shared_ptr<read_view> view_;
+    const block_database& blocks_;
+    const transaction_database& transactions_;
+    const hash_digest hash_;
+    std::atomic<bool> started_;
+    std::promise<block> promise_;
+    std::future<block> future_;
+};
+
+block_iterator::block_iterator()
+  : blocks_(nullptr),
+    transactions_(nullptr),
+    last_(0),
+    window_(0),
+    hash_offset_(0),
+    next_hash_height_(0),
+    height_(0),
+    valid_(false)
+{
+}
+
+block_iterator::block_iterator(std::shared_ptr<read_view> view,
+    const block_database& blocks, const transaction_database& transactions,
+    size_t first, size_t last, size_t window,
+    std::shared_ptr<query_pool> pool)
+  : view_(view),
+    pool_(pool),
+    blocks_(&blocks),
+    transactions_(&transactions),
+    last_(last),
+    window_(std::max(window, size_t{ 1 })),
+    hash_offset_(0),
+    next_hash_height_(first),
+    height_(first),
+    valid_(true)
+{
+    if (first > last)
+    {
+        valid_ = false;
+        return;
+    }
+
+    prefetch();
+    next();
+}
+
+block_iterator::~block_iterator()
+{
+    for (const auto& pending: pending_)
+        pending->abandon();
+}
+
+block_iterator::operator bool() const
+{
+    return valid_;
+}
+
+size_t block_iterator::height() const
+{
+    return height_;
+}
+
+block_iterator::reference block_iterator::operator*() const
+{
+    return current_;
+}
+
+block_iterator::pointer block_iterator::operator->() const
+{
+    return &current_;
+}
+
+block_iterator& block_iterator::operator++()
+{
+    ++height_;
+    prefetch();
+    next();
+    return *this;
+}
+
+// Only end iterators compare equal.
+bool block_iterator::operator==(const block_iterator& other) const
+{
+    return !(*this) && !other;
+}
+
+bool block_iterator::operator!=(const block_iterator& other) const
+{
+    return !(*this == other);
+}
+
+// private
+void block_iterator::read_hashes()
+{
+    if (next_hash_height_ > last_)
+        return;
+
+    const auto stop = std::min(last_, next_hash_height_ + window_ - 1);
+    hashes_ = blocks_->get_hashes(view_, next_hash_height_, stop, false);
+    hash_offset_ = 0;
+
+    // A gap in the index ends iteration at the gap.
+    next_hash_height_ = hashes_.size() == stop - next_hash_height_ + 1 ?
+        stop + 1 : last_ + 1;
+}
+
+// private
+void block_iterator::prefetch()
+{
+    while (valid_ && pending_.size() < window_)
+    {
+        if (hash_offset_ == hashes_.size())
+        {
+            hashes_.clear();
+            read_hashes();
+            if (hashes_.empty())
+                return;
+        }
+
+        // Views are thread safe, and results keep the view alive.
+        const auto pending = std::make_shared<read>(view_, *blocks_,
+            *transactions_, hashes_[hash_offset_++]);
+        pending_.push_back(pending);
+
+        // A refused read is made when needed, so the window stops here.
+        if (!pool_ || !pool_->post([pending]() { pending->run(); }))
+            return;
+    }
+}
+
+// private
+void block_iterator::next()
+{
+    if (pending_.empty())
+    {
+        valid_ = false;
+        return;
+    }
+
+    current_ = pending_.front()->get();
+    pending_.pop_front();
+
+    // Every block has a coinbase, so no transactions is a failed read.
+    valid_ = !current_.transactions().empty();
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/result/block_result.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/block_state.hpp>
+#include <bitcoin/database/slice.hpp>
+#include "rocksdb/db.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+block_result::block_result()
+  : block_result(nullptr, nullptr, {}, 0, 0, block_state::missing, 0)
+{
+}
+
+block_result::block_result(std::shared_ptr<reader> context,
+    rocksdb::ColumnFamilyHandle* block_transactions_handle,
+    const chain::header& header, size_t height, uint32_t median_time_past,
+    uint8_t state, uint32_t checksum)
+  : context_(context),
+    block_transactions_handle_(block_transactions_handle),
+    header_(header),
+    hash_(context ? header.hash() : null_hash),
+    height_(height),
+    median_time_past_(median_time_past),
+    state_(state),
+    checksum_(checksum)
+{
+}
+
+block_result::operator bool() const
+{
+    return context_ != nullptr;
+}
+
+hash_digest block_result::hash() const
+{
+    return hash_;
+}
+
+const chain::header& block_result::header() const
+{
+    return header_;
+}
+
+size_t block_result::height() const
+{
+    return height_;
+}
+
+uint32_t block_result::median_time_past() const
+{
+    return median_time_past_;
+}
+
+uint8_t block_result::state() const
+{
+    return state_;
+}
+
+// The checksum field holds the validation error code of a failed block.
+code block_result::error() const
+{
+    return is_failed(state_) ?
+        static_cast<error::error_code_t>(checksum_) : error::success;
+}
+
+size_t block_result::transaction_count() const
+{
+    return transaction_hashes().size();
+}
+
+// Transaction hashes are stored contiguously, keyed by block hash.
+hash_list block_result::transaction_hashes() const
+{
+    BITCOIN_ASSERT(context_);
+    std::string value;
+    const auto status = context_->get(block_transactions_handle_,
+        to_slice(hash_), &value);
+
+    if (!status.ok())
+        return {};
+
+    hash_list hashes(value.size() / hash_size);
+    auto data = value.data();
+
+    for (auto& hash: hashes)
+    {
+        std::copy_n(data, hash_size, hash.begin());
+        data += hash_size;
+    }
+
+    return hashes;
+}
+
+} // namespace database
+} // namespace libbitcoin
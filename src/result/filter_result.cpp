@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/result/filter_result.hpp>
+
+#include <cstdint>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/layouts.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+
+// Value: filter type, filter header, filter.
+static constexpr auto minimum_size = filter_prefix::record::size;
+
+filter_result::filter_result()
+  : valid_(false),
+    block_hash_(null_hash),
+    filter_type_(0),
+    header_(null_hash)
+{
+}
+
+filter_result::filter_result(const hash_digest& block_hash,
+    const data_chunk& value)
+  : filter_result()
+{
+    if (value.size() < minimum_size)
+        return;
+
+    filter_type_ = filter_prefix::type::get(value.data());
+    header_ = filter_prefix::header::get(value.data());
+    filter_.assign(value.begin() + minimum_size, value.end());
+    block_hash_ = block_hash;
+    valid_ = true;
+}
+
+filter_result::operator bool() const
+{
+    return valid_;
+}
+
+const hash_digest& filter_result::block_hash() const
+{
+    return block_hash_;
+}
+
+uint8_t filter_result::filter_type() const
+{
+    return filter_type_;
+}
+
+const hash_digest& filter_result::header() const
+{
+    return header_;
+}
+
+const data_chunk& filter_result::filter() const
+{
+    return filter_;
+}
+
+} // namespace database
+} // namespace libbitcoin
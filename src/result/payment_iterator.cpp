@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/result/payment_iterator.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/codec.hpp>
+#include <bitcoin/database/layouts.hpp>
+#include <bitcoin/database/result/payment_result.hpp>
+#include "rocksdb/db.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+
+payment_iterator::payment_iterator()
+  : payment_iterator(nullptr, nullptr, null_hash, 0)
+{
+}
+
+payment_iterator::payment_iterator(std::shared_ptr<reader> context,
+    std::shared_ptr<rocksdb::Iterator> iterator,
+    const hash_digest& script_hash, size_t limit)
+  : context_(context),
+    iterator_(iterator),
+    script_hash_(script_hash),
+    remaining_(limit)
+{
+    populate();
+}
+
+payment_iterator::operator bool() const
+{
+    return current_;
+}
+
+payment_iterator::reference payment_iterator::operator*() const
+{
+    return current_;
+}
+
+payment_iterator::pointer payment_iterator::operator->() const
+{
+    return &current_;
+}
+
+payment_iterator& payment_iterator::operator++()
+{
+    iterator_->Next();
+    populate();
+    return *this;
+}
+
+// Only end iterators compare equal.
+bool payment_iterator::operator==(const payment_iterator& other) const
+{
+    return !(*this) && !other;
+}
+
+bool payment_iterator::operator!=(const payment_iterator& other) const
+{
+    return !(*this == other);
+}
+
+// private
+void payment_iterator::populate()
+{
+    current_ = {};
+
+    if (!iterator_ || remaining_ == 0 || !iterator_->Valid())
+        return;
+
+    const auto key = iterator_->key();
+    const auto prefix = reinterpret_cast<const uint8_t*>(key.data());
+
+    if (key.size() < hash_size ||
+        !std::equal(script_hash_.begin(), script_hash_.end(), prefix))
+        return;
+
+    const auto value = iterator_->value();
+    if (value.size() != payment_value::record::size)
+        return;
+
+    const auto amount = payment_value::value::get(codec::to_bytes(value));
+
+    current_ = { data_chunk(prefix, prefix + key.size()), amount };
+    --remaining_;
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/result/payment_result.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/layouts.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+
+// Inverted big-endian fields order each script hash history newest first.
+static constexpr uint32_t input_flag = 0x80000000;
+static constexpr auto key_size = payment_key::record::size;
+
+const uint32_t payment_result::unconfirmed = max_uint32;
+
+payment_key::record::type payment_result::to_key(
+    const hash_digest& script_hash,
+    size_t height, size_t position, uint32_t index, bool is_output,
+    const hash_digest& hash)
+{
+    BITCOIN_ASSERT(height <= max_uint32);
+    BITCOIN_ASSERT(position <= max_uint16);
+    BITCOIN_ASSERT((index & input_flag) == 0);
+
+    const auto point = is_output ? index : (index | input_flag);
+
+    payment_key::record::type key;
+    payment_key::script_hash::put(key.data(), script_hash);
+    payment_key::height::put(key.data(), ~static_cast<uint32_t>(height));
+    payment_key::position::put(key.data(),
+        static_cast<uint16_t>(~static_cast<uint16_t>(position)));
+    payment_key::point::put(key.data(), ~point);
+    payment_key::hash::put(key.data(), hash);
+    return key;
+}
+
+payment_result::payment_result()
+  : hash_(null_hash),
+    height_(unconfirmed),
+    position_(max_uint16),
+    index_(0),
+    is_output_(false),
+    value_(0)
+{
+}
+
+payment_result::payment_result(const data_chunk& key, uint64_t value)
+  : payment_result()
+{
+    if (key.size() != key_size)
+        return;
+
+    const auto data = key.data();
+    height_ = ~payment_key::height::get(data);
+    position_ = static_cast<uint16_t>(~payment_key::position::get(data));
+    const auto point = ~payment_key::point::get(data);
+    hash_ = payment_key::hash::get(data);
+
+    is_output_ = (point & input_flag) == 0;
+    index_ = point & ~input_flag;
+    value_ = value;
+    cursor_ = key;
+}
+
+payment_result::operator bool() const
+{
+    return !cursor_.empty();
+}
+
+const hash_digest& payment_result::hash() const
+{
+    return hash_;
+}
+
+size_t payment_result::height() const
+{
+    return height_;
+}
+
+size_t payment_result::position() const
+{
+    return position_;
+}
+
+uint32_t payment_result::index() const
+{
+    return index_;
+}
+
+bool payment_result::is_output() const
+{
+    return is_output_;
+}
+
+uint64_t payment_result::value() const
+{
+    return value_;
+}
+
+bool payment_result::confirmed() const
+{
+    return height_ != unconfirmed;
+}
+
+const data_chunk& payment_result::cursor() const
+{
+    return cursor_;
+}
+
+} // namespace database
+} // namespace libbitcoin
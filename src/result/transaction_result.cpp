@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/result/transaction_result.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/slice.hpp>
+#include <bitcoin/database/transaction_record.hpp>
+#include "rocksdb/db.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+const uint8_t transaction_result::candidate_true = 1;
+const uint8_t transaction_result::candidate_false = 0;
+const uint32_t transaction_result::unverified = rule_fork::unverified;
+const uint16_t transaction_result::unconfirmed = max_uint16;
+const uint16_t transaction_result::deconfirmed = max_uint16 - 1u;
+
+transaction_result::transaction_result()
+  : transaction_result(nullptr, nullptr, null_hash, unverified, unconfirmed,
+        false, 0)
+{
+}
+
+transaction_result::transaction_result(std::shared_ptr<reader> context,
+    rocksdb::ColumnFamilyHandle* body_handle, const hash_digest& hash,
+    uint32_t height, uint16_t position, bool candidate,
+    uint32_t median_time_past)
+  : context_(context),
+    body_handle_(body_handle),
+    hash_(hash),
+    candidate_(candidate),
+    height_(height),
+    position_(position),
+    median_time_past_(median_time_past)
+{
+}
+
+transaction_result::transaction_result(const hash_digest& hash,
+    uint32_t forks, const data_chunk& body)
+  : transaction_result(nullptr, nullptr, hash, forks, unconfirmed, false, 0)
+{
+    pooled_body_ = body;
+}
+
+transaction_result::operator bool() const
+{
+    return context_ != nullptr || !pooled_body_.empty();
+}
+
+bool transaction_result::pooled() const
+{
+    return !pooled_body_.empty();
+}
+
+bool transaction_result::pruned() const
+{
+    return !pooled() && transaction_record::is_pruned(body());
+}
+
+hash_digest transaction_result::hash() const
+{
+    return hash_;
+}
+
+size_t transaction_result::height() const
+{
+    return height_;
+}
+
+size_t transaction_result::position() const
+{
+    return position_;
+}
+
+bool transaction_result::candidate() const
+{
+    return candidate_;
+}
+
+uint32_t transaction_result::median_time_past() const
+{
+    return median_time_past_;
+}
+
+// The body is stored separately from metadata (and may be in a blob file),
+// unless pooled.
+data_chunk transaction_result::body() const
+{
+    if (pooled())
+        return pooled_body_;
+
+    BITCOIN_ASSERT(context_);
+    std::string value;
+    const auto status = context_->get(body_handle_, to_slice(hash_),
+        &value);
+
+    return status.ok() ? to_chunk(value) : data_chunk{};
+}
+
+// Outputs are retained by pruned records.
+chain::output transaction_result::output(uint32_t index) const
+{
+    const auto tx = transaction_record::factory(body(), false);
+    const auto& outputs = tx.outputs();
+    return index < outputs.size() ? outputs[index] : chain::output{};
+}
+
+chain::transaction transaction_result::transaction(bool witness) const
+{
+    const auto data = body();
+    return transaction_record::is_pruned(data) ? chain::transaction{} :
+        transaction_record::factory(data, witness);
+}
+
+} // namespace database
+} // namespace libbitcoin
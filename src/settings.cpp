@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/settings.hpp>
+
+#include <algorithm>
+#include <thread>
+
+namespace libbitcoin {
+namespace database {
+
+static constexpr uint64_t mebibyte = 1024 * 1024;
+static constexpr uint64_t gibibyte = 1024 * mebibyte;
+
+// Background jobs of the initial block download and archive server presets.
+static int hardware_jobs()
+{
+    return std::max(static_cast<int>(std::thread::hardware_concurrency()), 2);
+}
+
+settings::settings()
+  : directory("blockchain"),
+    catalog(false),
+    filter(false),
+
+    // Memory.
+    memory_budget(4 * gibibyte),
+    block_cache_bytes(0),
+    cache_capacity(0),
+    write_buffer_bytes(64 * mebibyte),
+    unspent_spent_window(10),
+
+    // Compaction.
+    compaction_style(rocksdb::kCompactionStyleLevel),
+    max_background_jobs(2),
+    compaction_debt_limit(32 * gibibyte),
+    throttle_writes(false),
+    throttle_timeout(10000),
+
+    // Compression.
+    compression(rocksdb::kLZ4Compression),
+    family_compression(),
+    compression_dictionary_bytes(16 * 1024),
+    bottommost_compression(rocksdb::kZSTD),
+    bottommost_compression_level(9),
+    bottommost_dictionary_bytes(64 * 1024),
+    blob_threshold(256),
+    blob_garbage_collection_age_cutoff(0.25),
+    blob_garbage_collection_force_threshold(0.5),
+
+    // Durability.
+    sync_writes(false),
+    disable_wal(false),
+    max_total_wal_bytes(0),
+    direct_reads(false),
+    direct_writes(false),
+    backups_retained(4),
+    verify_depth(144),
+    verify_threads(4),
+
+    // Tiers.
+    data_paths(),
+    family_paths(),
+    last_level_temperature(rocksdb::Temperature::kUnknown),
+    hot_data_seconds(0),
+
+    // Pruning.
+    prune_depth(0),
+    prune_filters(false),
+
+    // Pool.
+    pool_expiry(14 * 24 * 60 * 60),
+    memory_pool(false),
+    memory_pool_bytes(0),
+
+    // Queries.
+    block_prefetch_window(16),
+    scan_readahead(2 * mebibyte),
+    query_threads(8),
+    query_max_in_flight(1024),
+    prefetch_threads(2),
+    prefetch_max_blocks(64),
+    catalog_chunk_blocks(100),
+
+    // Stats.
+    perf_sample_rate(0),
+    perf_log_interval(60)
+{
+}
+
+settings::settings(preset context)
+  : settings()
+{
+    switch (context)
+    {
+        case preset::initial_block_download:
+        {
+            // Larger memtables and more jobs keep compaction ahead of the
+            // write rate, which is throttled before rocksdb stalls writes.
+            memory_budget = 8 * gibibyte;
+            write_buffer_bytes = 256 * mebibyte;
+            max_background_jobs = hardware_jobs();
+            throttle_writes = true;
+
+            // Upper levels are soon rewritten, so are left uncompressed.
+            compression = rocksdb::kNoCompression;
+            compression_dictionary_bytes = 0;
+
+            // Bound the log so that memtables are flushed (together) before
+            // a long replay, as commits are not synced in any case.
+            max_total_wal_bytes = 4 * gibibyte;
+
+            // Compaction output is not read soon, so bypasses the page cache.
+            direct_writes = true;
+
+            // Blocks are mostly received in order and soon confirmed.
+            prefetch_threads = 4;
+            prefetch_max_blocks = 256;
+            unspent_spent_window = 6;
+            break;
+        }
+
+        case preset::archive_server:
+        {
+            // Cache reads in the block cache only and serve more of them.
+            memory_budget = 16 * gibibyte;
+            max_background_jobs = hardware_jobs();
+            direct_reads = true;
+            direct_writes = true;
+            query_threads = 32;
+            query_max_in_flight = 8192;
+            block_prefetch_window = 64;
+            scan_readahead = 8 * mebibyte;
+
+            // History is written once and read often, so compress it harder.
+            bottommost_compression_level = 19;
+            compression_dictionary_bytes = 64 * 1024;
+            bottommost_dictionary_bytes = 256 * 1024;
+            break;
+        }
+
+        case preset::low_memory:
+        {
+            memory_budget = 512 * mebibyte;
+            write_buffer_bytes = 16 * mebibyte;
+            max_background_jobs = 2;
+
+            // Keep compaction debt (and so disk use) low, writes wait for it.
+            compaction_debt_limit = 4 * gibibyte;
+            throttle_writes = true;
+
+            // Dictionaries are buffered in memory while trained.
+            compression_dictionary_bytes = 0;
+            bottommost_dictionary_bytes = 0;
+
+            query_threads = 2;
+            query_max_in_flight = 128;
+            prefetch_threads = 1;
+            prefetch_max_blocks = 8;
+            block_prefetch_window = 4;
+            scan_readahead = 256 * 1024;
+            verify_threads = 1;
+            break;
+        }
+
+        case preset::standard:
+        default:
+            break;
+    }
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -17,26 +17,30 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <bitcoin/database/transaction_context.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
 #include "rocksdb/db.h"
 
 namespace libbitcoin {
 namespace database {
 
-transaction_context::transaction_context(std::shared_ptr<rocksdb::OptimisticTransactionDB> db)
-  : db_(db)
+transaction_context::transaction_context(std::shared_ptr<rocksdb::OptimisticTransactionDB> db,
+    const rocksdb::WriteOptions& write_options)
+  : db_(db), write_options_(write_options)
 {
 }
 
 void
 transaction_context::begin(const bool use_snapshot)
 {
-    rocksdb::WriteOptions write_options;
     rocksdb::OptimisticTransactionOptions txn_options;
     if (use_snapshot) {
         txn_options.set_snapshot = true;
     }
     txn_ = std::shared_ptr<rocksdb::Transaction>(db_->BeginTransaction(
-          write_options, txn_options));
+          write_options_, txn_options));
 }
 
 bool
@@ -52,5 +56,37 @@ transaction_context::txn() const
     return txn_;
 }
 
+// The transaction snapshot (if any) only validates writes unless also read.
+rocksdb::ReadOptions
+transaction_context::read_options() const
+{
+    rocksdb::ReadOptions options;
+    options.snapshot = txn_->GetSnapshot();
+    return options;
+}
+
+rocksdb::Status
+transaction_context::get(rocksdb::ColumnFamilyHandle* handle,
+    const rocksdb::Slice& key, std::string* value) const
+{
+    return txn_->Get(read_options(), handle, key, value);
+}
+
+std::vector<rocksdb::Status>
+transaction_context::multi_get(
+    const std::vector<rocksdb::ColumnFamilyHandle*>& handles,
+    const std::vector<rocksdb::Slice>& keys,
+    std::vector<std::string>* values) const
+{
+    return txn_->MultiGet(read_options(), handles, keys, values);
+}
+
+rocksdb::Iterator*
+transaction_context::iterator(rocksdb::ColumnFamilyHandle* handle,
+    const rocksdb::ReadOptions& options) const
+{
+    return txn_->GetIterator(options, handle);
+}
+
 } // database
 } // libbitcoin
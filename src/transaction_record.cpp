@@ -0,0 +1,403 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/transaction_record.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <bitcoin/system.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+// Script template opcodes and sizes.
+static constexpr uint8_t op_0 = 0x00;
+static constexpr uint8_t op_1 = 0x51;
+static constexpr uint8_t op_dup = 0x76;
+static constexpr uint8_t op_equal = 0x87;
+static constexpr uint8_t op_equalverify = 0x88;
+static constexpr uint8_t op_hash160 = 0xa9;
+static constexpr uint8_t op_checksig = 0xac;
+static constexpr size_t short_hash_size = 20;
+static constexpr size_t long_hash_size = 32;
+static constexpr size_t compressed_key_size = 33;
+static constexpr size_t uncompressed_key_size = 65;
+
+// Amounts that would overflow compression are escaped and stored raw.
+static constexpr uint64_t escaped_amount = max_uint64;
+static constexpr uint64_t compressible_amount = max_uint64 / 100;
+
+// The witness flag follows the locktime.
+static constexpr uint8_t witness_false = 0;
+static constexpr uint8_t witness_true = 1;
+
+// Amounts.
+// ----------------------------------------------------------------------------
+
+// This is the bitcoind output amount compression.
+uint64_t transaction_record::compress_amount(uint64_t value)
+{
+    if (value == 0)
+        return 0;
+
+    uint64_t exponent = 0;
+    while ((value % 10) == 0 && exponent < 9)
+    {
+        value /= 10;
+        ++exponent;
+    }
+
+    if (exponent < 9)
+    {
+        const auto digit = value % 10;
+        value /= 10;
+        return 1 + (value * 9 + digit - 1) * 10 + exponent;
+    }
+
+    return 1 + (value - 1) * 10 + 9;
+}
+
+uint64_t transaction_record::expand_amount(uint64_t value)
+{
+    if (value == 0)
+        return 0;
+
+    --value;
+    auto exponent = value % 10;
+    value /= 10;
+
+    uint64_t amount;
+    if (exponent < 9)
+    {
+        const auto digit = (value % 9) + 1;
+        value /= 9;
+        amount = value * 10 + digit;
+    }
+    else
+    {
+        amount = value + 1;
+    }
+
+    for (; exponent > 0; --exponent)
+        amount *= 10;
+
+    return amount;
+}
+
+// Varints.
+// ----------------------------------------------------------------------------
+
+void transaction_record::write_varint(writer& sink, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        sink.write_byte(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    sink.write_byte(static_cast<uint8_t>(value));
+}
+
+uint64_t transaction_record::read_varint(reader& source)
+{
+    uint64_t value = 0;
+
+    for (size_t shift = 0; shift < 64; shift += 7)
+    {
+        const uint64_t byte = source.read_byte();
+        value |= (byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+
+    source.invalidate();
+    return 0;
+}
+
+// Scripts.
+// ----------------------------------------------------------------------------
+
+static bool is_pay_key_hash(const data_chunk& script)
+{
+    return script.size() == 25 && script[0] == op_dup &&
+        script[1] == op_hash160 && script[2] == short_hash_size &&
+        script[23] == op_equalverify && script[24] == op_checksig;
+}
+
+static bool is_pay_script_hash(const data_chunk& script)
+{
+    return script.size() == 23 && script[0] == op_hash160 &&
+        script[1] == short_hash_size && script[22] == op_equal;
+}
+
+static bool is_pay_witness_key_hash(const data_chunk& script)
+{
+    return script.size() == 22 && script[0] == op_0 &&
+        script[1] == short_hash_size;
+}
+
+static bool is_pay_witness_script_hash(const data_chunk& script)
+{
+    return script.size() == 34 && script[0] == op_0 &&
+        script[1] == long_hash_size;
+}
+
+static bool is_pay_taproot(const data_chunk& script)
+{
+    return script.size() == 34 && script[0] == op_1 &&
+        script[1] == long_hash_size;
+}
+
+static bool is_pay_compressed_key(const data_chunk& script)
+{
+    return script.size() == 35 && script[0] == compressed_key_size &&
+        (script[1] == 0x02 || script[1] == 0x03) && script[34] == op_checksig;
+}
+
+static bool is_pay_uncompressed_key(const data_chunk& script)
+{
+    return script.size() == 67 && script[0] == uncompressed_key_size &&
+        script[1] == 0x04 && script[66] == op_checksig;
+}
+
+static data_chunk template_data(uint8_t tag, const data_chunk& script,
+    size_t offset, size_t size)
+{
+    data_chunk out;
+    out.reserve(size + 1);
+    out.push_back(tag);
+    out.insert(out.end(), script.begin() + offset,
+        script.begin() + offset + size);
+    return out;
+}
+
+data_chunk transaction_record::compress_script(const data_chunk& script)
+{
+    if (is_pay_key_hash(script))
+        return template_data(pay_key_hash, script, 3, short_hash_size);
+
+    if (is_pay_script_hash(script))
+        return template_data(pay_script_hash, script, 2, short_hash_size);
+
+    if (is_pay_witness_key_hash(script))
+        return template_data(pay_witness_key_hash, script, 2,
+            short_hash_size);
+
+    if (is_pay_witness_script_hash(script))
+        return template_data(pay_witness_script_hash, script, 2,
+            long_hash_size);
+
+    if (is_pay_taproot(script))
+        return template_data(pay_taproot, script, 2, long_hash_size);
+
+    if (is_pay_compressed_key(script))
+        return template_data(pay_compressed_key, script, 1,
+            compressed_key_size);
+
+    if (is_pay_uncompressed_key(script))
+        return template_data(pay_uncompressed_key, script, 1,
+            uncompressed_key_size);
+
+    data_chunk out;
+    out.reserve(script.size() + 10);
+    data_sink ostream(out);
+    ostream_writer sink(ostream);
+    sink.write_byte(raw);
+    write_varint(sink, script.size());
+    sink.write_bytes(script);
+    ostream.flush();
+    return out;
+}
+
+data_chunk transaction_record::expand_script(reader& source)
+{
+    const auto wrap = [&](data_chunk&& prefix, size_t size,
+        data_chunk&& suffix)
+    {
+        auto payload = source.read_bytes(size);
+        prefix.reserve(prefix.size() + size + suffix.size());
+        prefix.insert(prefix.end(), payload.begin(), payload.end());
+        prefix.insert(prefix.end(), suffix.begin(), suffix.end());
+        return std::move(prefix);
+    };
+
+    switch (source.read_byte())
+    {
+        case raw:
+            return source.read_bytes(read_varint(source));
+        case pay_key_hash:
+            return wrap({ op_dup, op_hash160, short_hash_size },
+                short_hash_size, { op_equalverify, op_checksig });
+        case pay_script_hash:
+            return wrap({ op_hash160, short_hash_size }, short_hash_size,
+                { op_equal });
+        case pay_witness_key_hash:
+            return wrap({ op_0, short_hash_size }, short_hash_size, {});
+        case pay_witness_script_hash:
+            return wrap({ op_0, long_hash_size }, long_hash_size, {});
+        case pay_taproot:
+            return wrap({ op_1, long_hash_size }, long_hash_size, {});
+        case pay_compressed_key:
+            return wrap({ compressed_key_size }, compressed_key_size,
+                { op_checksig });
+        case pay_uncompressed_key:
+            return wrap({ uncompressed_key_size }, uncompressed_key_size,
+                { op_checksig });
+        default:
+            source.invalidate();
+            return {};
+    }
+}
+
+// Transactions.
+// ----------------------------------------------------------------------------
+
+static void write_amount(writer& sink, uint64_t value)
+{
+    if (value < compressible_amount)
+    {
+        transaction_record::write_varint(sink,
+            transaction_record::compress_amount(value));
+        return;
+    }
+
+    transaction_record::write_varint(sink, escaped_amount);
+    sink.write_8_bytes_little_endian(value);
+}
+
+static uint64_t read_amount(reader& source)
+{
+    const auto value = transaction_record::read_varint(source);
+
+    return value == escaped_amount ? source.read_8_bytes_little_endian() :
+        transaction_record::expand_amount(value);
+}
+
+data_chunk transaction_record::to_data(const transaction& tx)
+{
+    data_chunk out;
+    out.reserve(tx.serialized_size(true, true));
+    data_sink ostream(out);
+    ostream_writer sink(ostream);
+
+    sink.write_4_bytes_little_endian(tx.version());
+
+    // Inputs are stored in wire format, without witness.
+    const auto& inputs = tx.inputs();
+    sink.write_variable_little_endian(inputs.size());
+    for (const auto& input: inputs)
+    {
+        input.previous_output().to_data(sink, true);
+        input.script().to_data(sink, true);
+        sink.write_4_bytes_little_endian(input.sequence());
+    }
+
+    const auto& outputs = tx.outputs();
+    sink.write_variable_little_endian(outputs.size());
+    for (const auto& output: outputs)
+    {
+        write_amount(sink, output.value());
+        sink.write_bytes(compress_script(output.script().to_data(false)));
+    }
+
+    sink.write_4_bytes_little_endian(tx.locktime());
+
+    // Witnesses follow all inputs so that witness-less reads can stop here.
+    const auto segregated = tx.is_segregated();
+    sink.write_byte(segregated ? witness_true : witness_false);
+
+    if (segregated)
+        for (const auto& input: inputs)
+            input.witness().to_data(sink, true);
+
+    ostream.flush();
+    return out;
+}
+
+transaction transaction_record::factory(const data_chunk& data, bool witness)
+{
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    const auto version = source.read_4_bytes_little_endian();
+
+    input::list inputs(source.read_size_little_endian());
+    for (auto& input: inputs)
+    {
+        output_point previous_output;
+        previous_output.from_data(source, true);
+
+        script input_script;
+        input_script.from_data(source, true);
+
+        const auto sequence = source.read_4_bytes_little_endian();
+        input = { std::move(previous_output), std::move(input_script),
+            sequence };
+    }
+
+    output::list outputs(source.read_size_little_endian());
+    for (auto& output: outputs)
+    {
+        const auto value = read_amount(source);
+        output = { value, script::factory(expand_script(source), false) };
+    }
+
+    const auto locktime = source.read_4_bytes_little_endian();
+
+    if (witness && source.read_byte() == witness_true)
+    {
+        for (auto& input: inputs)
+        {
+            chain::witness input_witness;
+            input_witness.from_data(source, true);
+            input.set_witness(std::move(input_witness));
+        }
+    }
+
+    if (!source)
+        return {};
+
+    return { version, locktime, std::move(inputs), std::move(outputs) };
+}
+
+// The outputs remain spendable, inputs and witnesses are only needed to
+// validate (or serve) the tx itself.
+data_chunk transaction_record::to_pruned(const data_chunk& data)
+{
+    const auto tx = factory(data, false);
+    if (!tx.is_valid())
+        return {};
+
+    return to_data({ tx.version(), tx.locktime(), {}, tx.outputs() });
+}
+
+// A transaction has at least one input, so no inputs marks a pruned record.
+bool transaction_record::is_pruned(const data_chunk& data)
+{
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    source.read_4_bytes_little_endian();
+    const auto inputs = source.read_size_little_endian();
+    return source && inputs == 0;
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -27,10 +27,12 @@ namespace database {
 using namespace bc::system;
 using namespace bc::system::chain;
 
-// This does not differentiate indexed-block transactions. These are treated as
-// unconfirmed, so this optimizes only for a top height fork point and tx pool.
-unspent_outputs::unspent_outputs(size_t capacity)
-  : capacity_(capacity), hits_(1), queries_(1), sequence_(0)
+// This does not differentiate indexed-block transactions, these are treated as
+// unconfirmed. Confirmation and spend heights are retained, so any fork point
+// within the spent window is answered.
+unspent_outputs::unspent_outputs(size_t capacity, size_t spent_window)
+  : capacity_(capacity), spent_window_(spent_window), hits_(1), queries_(1),
+    sequence_(0)
 {
 }
 
@@ -81,22 +83,49 @@ void unspent_outputs::add(const transaction& tx, size_t height,
     ///////////////////////////////////////////////////////////////////////////
     unique_lock lock(mutex_);
 
-    // It's been a long time since the last restart (~16 years).
+    store(tx, height, median_time_past, confirmed);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void unspent_outputs::add(const block& block, size_t height,
+    uint32_t median_time_past)
+{
+    if (disabled())
+        return;
+
+    LOG_VERBOSE(LOG_DATABASE)
+        << "Output cache hit rate: " << hit_rate() << ", size: " << size();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (const auto& tx: block.transactions())
+        if (!tx.outputs().empty())
+            store(tx, height, median_time_past, true);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void unspent_outputs::add(unspent_transaction&& unspent)
+{
+    if (disabled() || unspent.outputs()->empty())
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
     if (sequence_ == max_uint32)
         unspent_.clear();
 
-    // Remove the oldest entry if the buffer is at capacity.
+    // A cached tx may have had outputs removed as spent, so is not replaced.
+    if (unspent_.left.find(unspent) != unspent_.left.end())
+        return;
+
     if (unspent_.size() >= capacity_)
         unspent_.right.erase(unspent_.right.begin());
 
-    // TODO: promote the unconfirmed/deconfirmed tx cache instead of
-    // replacing it.  A confirmed tx may replace the same
-    // unconfirmed/deconfirmed tx here.
-    unspent_.insert(
-    {
-        unspent_transaction{ tx, height, median_time_past, confirmed },
-        ++sequence_
-    });
+    unspent_.insert({ std::move(unspent), ++sequence_ });
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -168,7 +197,79 @@ void unspent_outputs::remove(const output_point& point)
     ///////////////////////////////////////////////////////////////////////////
 }
 
-// All responses are unspent, metadata should be defaulted by caller.
+void unspent_outputs::spend(const output_point& point, size_t spender_height)
+{
+    if (disabled())
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    spend_output(point, spender_height);
+    prune(spender_height);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void unspent_outputs::unconfirm(const transaction& tx)
+{
+    if (disabled())
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    demote(tx);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void unspent_outputs::apply(const block& block, size_t height,
+    uint32_t median_time_past)
+{
+    if (disabled())
+        return;
+
+    LOG_VERBOSE(LOG_DATABASE)
+        << "Output cache hit rate: " << hit_rate() << ", size: " << size();
+
+    const auto& txs = block.transactions();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // All txs are cached before spends, as txs may spend outputs of
+    // preceding txs of the same block.
+    for (const auto& tx: txs)
+        if (!tx.outputs().empty())
+            store(tx, height, median_time_past, true);
+
+    // Coinbase inputs do not spend.
+    for (size_t position = 1; position < txs.size(); ++position)
+        for (const auto& input: txs[position].inputs())
+            spend_output(input.previous_output(), height);
+
+    prune(height);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void unspent_outputs::revert(const block& block)
+{
+    if (disabled())
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (const auto& tx: block.transactions())
+        demote(tx);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Responses are unspent unless confirmed spent at or below the fork height,
+// metadata should be defaulted by caller.
 bool unspent_outputs::populate(const output_point& point,
     size_t fork_height) const
 {
@@ -204,8 +305,11 @@ bool unspent_outputs::populate(const output_point& point,
     prevout.candidate = false;
     prevout.candidate_spent = false;
 
-    // Cache removes outputs after they are confirmed spent.
-    prevout.confirmed_spent = false;
+    // Spent outputs are retained (within the window) with spender height.
+    const auto spenders = transaction.spenders();
+    const auto spender = spenders->find(point.index());
+    prevout.confirmed_spent = spender != spenders->end() &&
+        spender->second <= fork_height;
 
     // Unspent output is confirmed only if below the fork point.
     prevout.confirmed = transaction.is_confirmed() &&
@@ -220,5 +324,125 @@ bool unspent_outputs::populate(const output_point& point,
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// private
+// A cached tx is promoted in place, retaining outputs removed as spent and
+// spender heights, with its age refreshed. Caller must hold unique lock.
+void unspent_outputs::store(const transaction& tx, size_t height,
+    uint32_t median_time_past, bool confirmed)
+{
+    // It's been a long time since the last restart (~16 years).
+    if (sequence_ == max_uint32)
+        unspent_.clear();
+
+    const auto existing = unspent_.left.find(unspent_transaction{ tx.hash() });
+    if (existing != unspent_.left.end())
+    {
+        // A confirmed tx is not demoted by the same tx as unconfirmed.
+        if (existing->first.is_confirmed() && !confirmed)
+            return;
+
+        unspent_.left.replace_key(existing,
+            existing->first.reconfirm(height, median_time_past, confirmed));
+        unspent_.left.replace_data(existing, ++sequence_);
+        return;
+    }
+
+    // Remove the oldest entry if the buffer is at capacity.
+    if (unspent_.size() >= capacity_)
+        unspent_.right.erase(unspent_.right.begin());
+
+    unspent_.insert(
+    {
+        unspent_transaction{ tx, height, median_time_past, confirmed },
+        ++sequence_
+    });
+}
+
+// private
+// Mark the output spent at the height, or remove it if there is no spent
+// window. Caller must hold unique lock.
+void unspent_outputs::spend_output(const output_point& point,
+    size_t spender_height)
+{
+    const auto tx = unspent_.left.find(unspent_transaction{ point });
+    if (tx == unspent_.left.end())
+        return;
+
+    const auto outputs = tx->first.outputs();
+    if (outputs->count(point.index()) == 0)
+        return;
+
+    if (spent_window_ != 0)
+    {
+        (*tx->first.spenders())[point.index()] = spender_height;
+        spent_.emplace_back(spender_height, point);
+        return;
+    }
+
+    // Erase the output, and the unspent transaction if now fully spent.
+    outputs->erase(point.index());
+
+    if (outputs->empty())
+        unspent_.left.erase(tx);
+}
+
+// private
+// Remove outputs spent below the window, unless since unspent (or respent at
+// another height by reorganization). Caller must hold unique lock.
+void unspent_outputs::prune(size_t spender_height)
+{
+    while (!spent_.empty() &&
+        spent_.front().first + spent_window_ <= spender_height)
+    {
+        const auto& spent = spent_.front();
+        const auto entry = unspent_.left.find(
+            unspent_transaction{ spent.second });
+
+        if (entry != unspent_.left.end())
+        {
+            const auto index = spent.second.index();
+            const auto spenders = entry->first.spenders();
+            const auto spender = spenders->find(index);
+
+            if (spender != spenders->end() && spender->second == spent.first)
+            {
+                spenders->erase(spender);
+                entry->first.outputs()->erase(index);
+
+                if (entry->first.outputs()->empty())
+                    unspent_.left.erase(entry);
+            }
+        }
+
+        spent_.pop_front();
+    }
+}
+
+// private
+// The outputs of the tx remain cached as unconfirmed (pooled), and outputs
+// it spent within the window are unspent again. Caller must hold unique lock.
+void unspent_outputs::demote(const transaction& tx)
+{
+    const auto entry = unspent_.left.find(unspent_transaction{ tx.hash() });
+    if (entry != unspent_.left.end())
+    {
+        unspent_.left.replace_key(entry,
+            entry->first.reconfirm(rule_fork::unverified, 0, false));
+        unspent_.left.replace_data(entry, ++sequence_);
+    }
+
+    if (tx.is_coinbase())
+        return;
+
+    for (const auto& input: tx.inputs())
+    {
+        const auto& point = input.previous_output();
+        const auto spent = unspent_.left.find(unspent_transaction{ point });
+
+        if (spent != unspent_.left.end())
+            spent->first.spenders()->erase(point.index());
+    }
+}
+
 } // namespace database
 } // namespace libbitcoin
@@ -36,7 +36,8 @@ unspent_transaction::unspent_transaction(unspent_transaction&& other)
     is_coinbase_(other.is_coinbase_),
     is_confirmed_(other.is_confirmed_),
     hash_(std::move(other.hash_)),
-    outputs_(other.outputs_)
+    outputs_(other.outputs_),
+    spenders_(other.spenders_)
 {
 }
 
@@ -46,7 +47,8 @@ unspent_transaction::unspent_transaction(const unspent_transaction& other)
     is_coinbase_(other.is_coinbase_),
     is_confirmed_(other.is_confirmed_),
     hash_(other.hash_),
-    outputs_(other.outputs_)
+    outputs_(other.outputs_),
+    spenders_(other.spenders_)
 {
 }
 
@@ -56,7 +58,8 @@ unspent_transaction::unspent_transaction(const hash_digest& hash)
     is_coinbase_(false),
     is_confirmed_(false),
     hash_(hash),
-    outputs_(std::make_shared<output_map>())
+    outputs_(std::make_shared<output_map>()),
+    spenders_(std::make_shared<spender_map>())
 {
 }
 
@@ -72,7 +75,8 @@ unspent_transaction::unspent_transaction(const chain::transaction& tx,
     is_coinbase_(tx.is_coinbase()),
     is_confirmed_(confirmed),
     hash_(tx.hash()),
-    outputs_(std::make_shared<output_map>())
+    outputs_(std::make_shared<output_map>()),
+    spenders_(std::make_shared<spender_map>())
 {
     const auto& outputs = tx.outputs();
     const auto size = safe_unsigned<uint32_t>(outputs.size());
@@ -83,6 +87,18 @@ unspent_transaction::unspent_transaction(const chain::transaction& tx,
         (*outputs_)[index] = outputs[index];
 }
 
+unspent_transaction::unspent_transaction(const hash_digest& hash,
+    size_t height, uint32_t median_time_past, bool coinbase, bool confirmed)
+  : height_(height),
+    median_time_past_(median_time_past),
+    is_coinbase_(coinbase),
+    is_confirmed_(confirmed),
+    hash_(hash),
+    outputs_(std::make_shared<output_map>()),
+    spenders_(std::make_shared<spender_map>())
+{
+}
+
 const hash_digest& unspent_transaction::hash() const
 {
     return hash_;
@@ -113,6 +129,21 @@ unspent_transaction::output_map_ptr unspent_transaction::outputs() const
     return outputs_;
 }
 
+unspent_transaction::spender_map_ptr unspent_transaction::spenders() const
+{
+    return spenders_;
+}
+
+unspent_transaction unspent_transaction::reconfirm(size_t height,
+    uint32_t median_time_past, bool confirmed) const
+{
+    auto copy = *this;
+    copy.height_ = height;
+    copy.median_time_past_ = median_time_past;
+    copy.is_confirmed_ = confirmed;
+    return copy;
+}
+
 // For the purpose of bimap identity only the tx hash matters.
 bool unspent_transaction::operator==(const unspent_transaction& other) const
 {
@@ -128,6 +159,7 @@ unspent_transaction& unspent_transaction::operator=(
     is_confirmed_ = other.is_confirmed_;
     hash_ = std::move(other.hash_);
     outputs_ = other.outputs_;
+    spenders_ = other.spenders_;
     return *this;
 }
 
@@ -140,6 +172,7 @@ unspent_transaction& unspent_transaction::operator=(
     is_confirmed_ = other.is_confirmed_;
     hash_ = other.hash_;
     outputs_ = other.outputs_;
+    spenders_ = other.spenders_;
     return *this;
 }
 
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/verify.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/database/block_state.hpp>
+#include <bitcoin/database/databases/block_database.hpp>
+#include <bitcoin/database/databases/transaction_database.hpp>
+#include <bitcoin/database/result/block_result.hpp>
+#include <bitcoin/database/result/transaction_result.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::system;
+
+code verify(std::shared_ptr<reader> context, const block_database& blocks,
+    const transaction_database& transactions, size_t height, bool candidate)
+{
+    const auto result = blocks.get(context, height, candidate);
+    if (!result)
+        return blocks.get_hashes(context, height, height, candidate).empty() ?
+            error::not_found : error::store_block_missing_parent;
+
+    if (result.height() != height)
+        return error::store_block_invalid_height;
+
+    // The block links to the block below it in the same index.
+    if (height > 0)
+    {
+        const auto below = blocks.get_hashes(context, height - 1, height - 1,
+            candidate);
+
+        if (below.empty() ||
+            below.front() != result.header().previous_block_hash())
+            return error::store_block_missing_parent;
+    }
+
+    // Confirmed blocks remain in the candidate index.
+    const auto state = result.state();
+    if (candidate ? !is_candidate(state) && !is_confirmed(state) :
+        !is_confirmed(state))
+        return error::store_incorrect_state;
+
+    if (candidate)
+        return error::success;
+
+    // Each tx of a confirmed block is confirmed at its height and position.
+    const auto hashes = result.transaction_hashes();
+    if (hashes.empty())
+        return error::store_block_missing_parent;
+
+    for (size_t position = 0; position < hashes.size(); ++position)
+    {
+        const auto tx = transactions.get(context, hashes[position]);
+        if (!tx || tx.height() != height || tx.position() != position)
+            return error::store_incorrect_state;
+    }
+
+    return error::success;
+}
+
+// Heights are interleaved across threads, so that each covers the range.
+std::vector<code> verify(std::shared_ptr<read_view> view,
+    const block_database& blocks, const transaction_database& transactions,
+    size_t first, size_t last, bool candidate, size_t threads)
+{
+    if (first > last)
+        return {};
+
+    std::vector<code> results(last - first + 1, error::success);
+    const auto count = std::max<size_t>(1, std::min(threads,
+        results.size()));
+
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(count);
+
+    for (size_t task = 0; task < count; ++task)
+    {
+        tasks.push_back(std::async(std::launch::async, [&, task]()
+        {
+            for (auto index = task; index < results.size(); index += count)
+                results[index] = verify(view, blocks, transactions,
+                    first + index, candidate);
+        }));
+    }
+
+    for (auto& task: tasks)
+        task.get();
+
+    return results;
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/write_pressure.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <bitcoin/system.hpp>
+#include "rocksdb/db.h"
+#include "rocksdb/listener.h"
+
+namespace libbitcoin {
+namespace database {
+
+using namespace std::chrono;
+
+static write_pressure::stall to_stall(rocksdb::WriteStallCondition condition)
+{
+    switch (condition)
+    {
+        case rocksdb::WriteStallCondition::kStopped:
+            return write_pressure::stopped;
+        case rocksdb::WriteStallCondition::kDelayed:
+            return write_pressure::delayed;
+        default:
+            return write_pressure::normal;
+    }
+}
+
+write_pressure::write_pressure()
+  : counters_()
+{
+}
+
+write_pressure::stall write_pressure::condition() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return worst();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool write_pressure::backpressure(uint64_t debt_threshold) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return worst() != normal || (debt_threshold != 0 &&
+        counters_.compaction_debt > debt_threshold);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+write_pressure::counters write_pressure::get() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto out = counters_;
+
+    // Include the duration of a current stall.
+    if (worst() != normal)
+        out.stall_nanoseconds += duration_cast<nanoseconds>(clock::now() -
+            stalled_).count();
+
+    return out;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool write_pressure::wait(uint64_t debt_threshold,
+    milliseconds timeout) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    return condition_.wait_for(lock, timeout, [&]()
+    {
+        return relieved(debt_threshold);
+    });
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Events.
+// ----------------------------------------------------------------------------
+
+void write_pressure::OnFlushBegin(rocksdb::DB*, const rocksdb::FlushJobInfo&)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ++counters_.active_flushes;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void write_pressure::OnFlushCompleted(rocksdb::DB* db,
+    const rocksdb::FlushJobInfo&)
+{
+    uint64_t debt;
+    const auto read = read_debt(db, debt);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        ++counters_.flushes;
+        if (counters_.active_flushes > 0)
+            --counters_.active_flushes;
+
+        if (read)
+            counters_.compaction_debt = debt;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    condition_.notify_all();
+}
+
+void write_pressure::OnCompactionBegin(rocksdb::DB*,
+    const rocksdb::CompactionJobInfo&)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ++counters_.active_compactions;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void write_pressure::OnCompactionCompleted(rocksdb::DB* db,
+    const rocksdb::CompactionJobInfo&)
+{
+    uint64_t debt;
+    const auto read = read_debt(db, debt);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        ++counters_.compactions;
+        if (counters_.active_compactions > 0)
+            --counters_.active_compactions;
+
+        if (read)
+            counters_.compaction_debt = debt;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    condition_.notify_all();
+}
+
+void write_pressure::OnStallConditionsChanged(
+    const rocksdb::WriteStallInfo& info)
+{
+    const auto current = to_stall(info.condition.cur);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const auto before = worst();
+        conditions_[info.cf_name] = current;
+        const auto after = worst();
+
+        if (current == delayed)
+            ++counters_.delays;
+        else if (current == stopped)
+            ++counters_.stops;
+
+        // Stall time is the time any family is delayed or stopped.
+        const auto now = clock::now();
+        if (before == normal && after != normal)
+            stalled_ = now;
+        else if (before != normal && after == normal)
+            counters_.stall_nanoseconds += duration_cast<nanoseconds>(now -
+                stalled_).count();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    condition_.notify_all();
+}
+
+// private
+// Caller must hold mutex.
+write_pressure::stall write_pressure::worst() const
+{
+    auto out = normal;
+    for (const auto& condition: conditions_)
+        out = std::max(out, condition.second);
+
+    return out;
+}
+
+// private
+// Caller must hold mutex.
+bool write_pressure::relieved(uint64_t debt_threshold) const
+{
+    return worst() != stopped && (debt_threshold == 0 ||
+        counters_.compaction_debt <= debt_threshold);
+}
+
+// private
+// Read outside of the mutex, as this takes the rocksdb mutex.
+bool write_pressure::read_debt(rocksdb::DB* db, uint64_t& out_debt)
+{
+    return db != nullptr && db->GetAggregatedIntProperty(
+        rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &out_debt);
+}
+
+} // namespace database
+} // namespace libbitcoin
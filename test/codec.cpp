@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::database;
+using namespace bc::system;
+
+static_assert(block_index_key::record::size == 5, "block index key");
+static_assert(block_value::record::size == 88, "block value");
+static_assert(block_state_value::record::size == 5, "block state value");
+static_assert(metadata_value::record::size == 11, "metadata value");
+static_assert(pool_prefix::record::size == 8, "pool prefix");
+static_assert(payment_key::record::size == 74, "payment key");
+static_assert(filter_prefix::record::size == 33, "filter prefix");
+
+BOOST_AUTO_TEST_SUITE(codec_tests)
+
+BOOST_AUTO_TEST_CASE(codec__big_endian__round_trip__expected)
+{
+    typedef codec::big_endian<codec::origin, uint8_t> first;
+    typedef codec::big_endian<first, uint32_t> second;
+    codec::record<second>::type record;
+    first::put(record.data(), 0x2a);
+    second::put(record.data(), 0x01020304);
+
+    const codec::record<second>::type expected{ { 0x2a, 1, 2, 3, 4 } };
+    BOOST_REQUIRE(record == expected);
+    BOOST_REQUIRE_EQUAL(first::get(record.data()), 0x2au);
+    BOOST_REQUIRE_EQUAL(second::get(record.data()), 0x01020304u);
+}
+
+BOOST_AUTO_TEST_CASE(codec__little_endian__round_trip__expected)
+{
+    typedef codec::little_endian<codec::origin, uint16_t> first;
+    typedef codec::little_endian<first, uint64_t> second;
+    codec::record<second>::type record;
+    first::put(record.data(), 0x0102);
+    second::put(record.data(), 0x0102030405060708);
+
+    const codec::record<second>::type expected
+    {
+        { 2, 1, 8, 7, 6, 5, 4, 3, 2, 1 }
+    };
+    BOOST_REQUIRE(record == expected);
+    BOOST_REQUIRE_EQUAL(first::get(record.data()), 0x0102u);
+    BOOST_REQUIRE_EQUAL(second::get(record.data()), 0x0102030405060708u);
+}
+
+BOOST_AUTO_TEST_CASE(codec__block_index_key__heights__ordered)
+{
+    block_index_key::record::type low;
+    block_index_key::record::type high;
+    block_index_key::height::put(low.data(), 0x000000ff);
+    block_index_key::height::put(high.data(), 0x00000100);
+    low[0] = high[0] = 1;
+
+    BOOST_REQUIRE(low < high);
+}
+
+BOOST_AUTO_TEST_CASE(codec__payment_key__round_trip__expected)
+{
+    const auto script_hash = hash_literal(
+        "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+    const auto key = payment_result::to_key(script_hash, 42, 7, 3, false,
+        null_hash);
+    const payment_result result({ key.begin(), key.end() }, 1000);
+
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE(payment_key::script_hash::get(key.data()) == script_hash);
+    BOOST_REQUIRE_EQUAL(result.height(), 42u);
+    BOOST_REQUIRE_EQUAL(result.position(), 7u);
+    BOOST_REQUIRE_EQUAL(result.index(), 3u);
+    BOOST_REQUIRE(!result.is_output());
+    BOOST_REQUIRE_EQUAL(result.value(), 1000u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
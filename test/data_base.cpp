@@ -18,6 +18,8 @@
  */
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <future>
 #include <boost/filesystem.hpp>
 #include <bitcoin/database.hpp>
 #include "./utility/utility.hpp"
@@ -72,13 +74,520 @@ BOOST_AUTO_TEST_CASE(data_base__create__genesis_block_available__success)
     const auto block_hash = genesis.hash();
     BOOST_CHECK(instance.create(genesis));
 
-    // auto context = instance.begin_transaction();
-    // const auto result_by_hash = instance.blocks().get(context, block_hash);
-    // context->commit();
-    // BOOST_REQUIRE(result_by_hash);
-    // BOOST_REQUIRE(result_by_hash.hash() == block_hash);
+    auto context = instance.begin_transaction();
+    const auto result_by_hash = instance.blocks().get(context, block_hash);
+    const auto result_by_height = instance.blocks().get(context, 0, false);
+    context->commit();
+    BOOST_REQUIRE(result_by_hash);
+    BOOST_REQUIRE(result_by_hash.hash() == block_hash);
+    BOOST_REQUIRE(result_by_height);
+    BOOST_REQUIRE(result_by_height.hash() == block_hash);
+    BOOST_REQUIRE_EQUAL(result_by_height.transaction_count(), 1u);
 
     BOOST_CHECK(instance.close());
 }
 
+BOOST_AUTO_TEST_CASE(data_base__create__catalog__genesis_payment_available)
+{
+    data_base instance(file_path, true, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    BOOST_REQUIRE(instance.create(genesis));
+
+    const auto& coinbase = genesis.transactions().front();
+    const auto script_hash = payment_database::to_script_hash(
+        coinbase.outputs().front().script());
+
+    auto context = instance.begin_transaction();
+    auto payment = instance.payments().get(context, script_hash);
+    BOOST_REQUIRE(payment);
+    BOOST_REQUIRE(payment->hash() == coinbase.hash());
+    BOOST_REQUIRE(payment->is_output());
+    BOOST_REQUIRE_EQUAL(payment->height(), 0u);
+    BOOST_REQUIRE_EQUAL(payment->value(), coinbase.outputs().front().value());
+
+    // The next page (after the only payment) is empty.
+    BOOST_REQUIRE(!instance.payments().get(context, script_hash,
+        payment->cursor()));
+    BOOST_REQUIRE(!++payment);
+    context->commit();
+
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__index_catalog__deferred__goes_live)
+{
+    data_base instance(file_path, true, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    BOOST_REQUIRE(instance.create(bc_settings.genesis_block));
+    BOOST_REQUIRE(instance.catalog_live());
+
+    instance.defer_catalog();
+    BOOST_REQUIRE(!instance.catalog_live());
+    BOOST_REQUIRE(instance.index_catalog(2, nullptr));
+
+    // Closing joins the indexer, which has nothing left to build.
+    BOOST_CHECK(instance.close());
+    BOOST_REQUIRE(instance.catalog_live());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__index_catalog__chunks__payments_ingested)
+{
+    database::settings settings;
+    settings.directory = file_path;
+    settings.catalog = true;
+    settings.catalog_chunk_blocks = 2;
+    data_base instance(settings);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    const auto& coinbase = genesis.transactions().front();
+    BOOST_REQUIRE(instance.create(genesis));
+    instance.defer_catalog();
+
+    // Each coinbase is made unique by its lock time, and pays the genesis
+    // coinbase script.
+    const size_t top = 6;
+    auto previous = genesis.hash();
+    for (uint32_t height = 1; height <= top; ++height)
+    {
+        const chain::transaction next(1, height,
+            { { { null_hash, point::null_index }, {}, 0 } },
+            coinbase.outputs());
+        const chain::header header(1, previous, next.hash(), height, 0, 0);
+        const chain::block block(header, { next });
+        previous = block.hash();
+
+        const auto context = instance.begin_transaction();
+        BOOST_REQUIRE_EQUAL(instance.push(context, block, height),
+            error::success);
+        BOOST_REQUIRE(instance.commit_transaction(context));
+    }
+
+    // Heights 1 through 6 are indexed in three ingested chunks.
+    size_t progress = 0;
+    std::promise<code> complete;
+    BOOST_REQUIRE(instance.index_catalog(2,
+        [&](size_t indexed, size_t)
+        {
+            progress = std::max(progress, indexed);
+        },
+        [&](const code& ec)
+        {
+            complete.set_value(ec);
+        }));
+
+    BOOST_REQUIRE_EQUAL(complete.get_future().get(), error::success);
+    BOOST_REQUIRE_EQUAL(progress, top);
+    BOOST_REQUIRE(instance.catalog_live());
+
+    const auto script_hash = payment_database::to_script_hash(
+        coinbase.outputs().front().script());
+
+    auto context = instance.begin_transaction();
+    auto height = top;
+    for (auto payment = instance.payments().get(context, script_hash);
+        payment; ++payment, --height)
+    {
+        BOOST_REQUIRE(payment->is_output());
+        BOOST_REQUIRE_EQUAL(payment->height(), height);
+    }
+
+    // Newest first, through genesis.
+    BOOST_REQUIRE_EQUAL(height, max_size_t);
+    context->commit();
+
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__create__filter__genesis_filter_available)
+{
+    data_base instance(file_path, false, true);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    const auto block_hash = genesis.hash();
+    BOOST_REQUIRE(instance.create(genesis));
+
+    data_chunk expected;
+    BOOST_REQUIRE(filter_database::compute(genesis, expected));
+
+    auto context = instance.begin_transaction();
+    const auto result = instance.filters().get(context, block_hash);
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE(result.filter() == expected);
+    BOOST_REQUIRE(result.header() ==
+        neutrino::compute_filter_header(null_hash, expected));
+
+    const auto range = instance.filters().get(context, 0, block_hash, 1000);
+    BOOST_REQUIRE_EQUAL(range.size(), 1u);
+    BOOST_REQUIRE(range.front().block_hash() == block_hash);
+    BOOST_REQUIRE(instance.filters().get(context, 1, block_hash,
+        1000).empty());
+    context->commit();
+
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__index_filters__filter_enabled__genesis_filter_built)
+{
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+
+    data_base unfiltered(file_path, false, false);
+    BOOST_REQUIRE(unfiltered.create(genesis));
+    BOOST_REQUIRE(unfiltered.close());
+
+    // Filters are built in the background through the confirmed top.
+    data_base instance(file_path, false, true);
+    BOOST_REQUIRE(instance.open());
+
+    std::promise<code> complete;
+    BOOST_REQUIRE(instance.index_filters([&](const code& ec)
+    {
+        complete.set_value(ec);
+    }));
+    BOOST_REQUIRE_EQUAL(complete.get_future().get(), error::success);
+
+    data_chunk expected;
+    BOOST_REQUIRE(filter_database::compute(genesis, expected));
+
+    auto context = instance.begin_transaction();
+    const auto result = instance.filters().get(context, genesis.hash());
+    context->commit();
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE(result.filter() == expected);
+
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__store__unconfirmed__pooled)
+{
+    data_base instance(file_path, false, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    BOOST_REQUIRE(instance.create(bc_settings.genesis_block));
+
+    transaction tx;
+    BOOST_REQUIRE(tx.from_data(to_chunk(base16_literal(TRANSACTION1))));
+    BOOST_REQUIRE_EQUAL(instance.store(tx, 42), error::success);
+    BOOST_REQUIRE(!tx.metadata.existed);
+
+    auto context = instance.begin_transaction();
+    const auto result = instance.transactions().get(context, tx.hash());
+    context->commit();
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE(result.pooled());
+    BOOST_REQUIRE_EQUAL(result.height(), 42u);
+    BOOST_REQUIRE_EQUAL(result.position(), transaction_result::unconfirmed);
+    BOOST_REQUIRE(result.transaction() == tx);
+
+    // A pooled tx is not pooled again.
+    BOOST_REQUIRE_EQUAL(instance.store(tx, 42), error::success);
+    BOOST_REQUIRE(tx.metadata.existed);
+
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__begin_read__later_store__not_visible)
+{
+    data_base instance(file_path, false, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    BOOST_REQUIRE(instance.create(genesis));
+
+    transaction tx;
+    BOOST_REQUIRE(tx.from_data(to_chunk(base16_literal(TRANSACTION1))));
+
+    auto view = instance.begin_read();
+    BOOST_REQUIRE_EQUAL(instance.store(tx, 42), error::success);
+    BOOST_REQUIRE(instance.blocks().get(view, genesis.hash()));
+    BOOST_REQUIRE(!instance.transactions().get(view, tx.hash()));
+    BOOST_REQUIRE(instance.transactions().get(instance.begin_read(),
+        tx.hash()));
+
+    // The store is not closed while a view is held.
+    BOOST_REQUIRE(!instance.close());
+    BOOST_REQUIRE(instance.blocks().get(view, genesis.hash()));
+
+    view.reset();
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__read_blocks__genesis__one_block)
+{
+    data_base instance(file_path, false, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    BOOST_REQUIRE(instance.create(genesis));
+
+    // The iterator (and its view) is released before close.
+    {
+        auto blocks = instance.read_blocks(0, 10);
+        BOOST_REQUIRE(blocks);
+        BOOST_REQUIRE_EQUAL(blocks.height(), 0u);
+        BOOST_REQUIRE(blocks->hash() == genesis.hash());
+        BOOST_REQUIRE(*blocks == genesis);
+        BOOST_REQUIRE(!++blocks);
+        BOOST_REQUIRE(!instance.read_blocks(1, 10));
+    }
+
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__scan_transactions__genesis__coinbase)
+{
+    data_base instance(file_path, false, false);
+    BOOST_REQUIRE(!instance.scan_transactions([](const transaction&)
+    {
+        return true;
+    }));
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    BOOST_REQUIRE(instance.create(genesis));
+
+    transaction::list visited;
+    BOOST_REQUIRE(instance.scan_transactions([&](const transaction& tx)
+    {
+        visited.push_back(tx);
+        return true;
+    }));
+
+    BOOST_REQUIRE_EQUAL(visited.size(), 1u);
+    BOOST_REQUIRE(visited.front() == genesis.transactions().front());
+
+    // The scan stops with the visitor.
+    BOOST_REQUIRE(!instance.scan_transactions([](const transaction&)
+    {
+        return false;
+    }));
+
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__get_block__async_genesis__found)
+{
+    data_base instance(file_path, false, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    BOOST_REQUIRE(instance.create(genesis));
+
+    std::promise<code> found;
+    instance.get_block(genesis.hash(), [&](const code& ec, block_result block)
+    {
+        found.set_value(ec ? ec : (block.height() == 0u ? error::success :
+            error::operation_failed));
+    });
+
+    std::promise<code> missing;
+    instance.get_block(1, false, [&](const code& ec, block_result)
+    {
+        missing.set_value(ec);
+    });
+
+    BOOST_REQUIRE_EQUAL(found.get_future().get(), error::success);
+    BOOST_REQUIRE_EQUAL(missing.get_future().get(), error::not_found);
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__prefetch__spends_genesis_coinbase__cached)
+{
+    data_base instance(file_path, false, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    BOOST_REQUIRE(instance.create(genesis));
+
+    const auto& coinbase = genesis.transactions().front();
+    const output_point spent{ coinbase.hash(), 0 };
+    chain::transaction spender(1, 0, { { spent, {}, 0 } }, {});
+    const chain::block block(genesis.header(), { coinbase, spender });
+
+    auto view = instance.begin_read();
+    BOOST_REQUIRE_EQUAL(instance.transactions_->prefetch(view, block), 1u);
+    BOOST_REQUIRE(instance.transactions().get_output(view, spent,
+        max_size_t));
+    BOOST_REQUIRE(spent.metadata.cache == coinbase.outputs().front());
+
+    view.reset();
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__checkpoint__open_checkpoint__success)
+{
+    data_base instance(file_path, false, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    BOOST_REQUIRE(instance.create(bc_settings.genesis_block));
+    BOOST_REQUIRE(instance.checkpoint(DIRECTORY "/checkpoint"));
+    BOOST_CHECK(instance.close());
+
+    data_base copy(DIRECTORY "/checkpoint", false, false);
+    BOOST_CHECK(copy.open());
+    BOOST_CHECK(copy.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__verify__genesis__success)
+{
+    data_base instance(file_path, false, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    BOOST_REQUIRE(instance.create(bc_settings.genesis_block));
+
+    auto view = instance.begin_read();
+    const auto confirmed = verify(view, instance.blocks(),
+        instance.transactions(), 0, 1, false, 2);
+    BOOST_REQUIRE_EQUAL(confirmed.size(), 2u);
+    BOOST_REQUIRE_EQUAL(confirmed[0], error::success);
+    BOOST_REQUIRE_EQUAL(confirmed[1], error::not_found);
+    BOOST_REQUIRE_EQUAL(verify(view, instance.blocks(),
+        instance.transactions(), 0, true), error::success);
+
+    view.reset();
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__checkpoint__closed__failure)
+{
+    data_base instance(file_path, false, false);
+    BOOST_REQUIRE(!instance.checkpoint(DIRECTORY "/checkpoint"));
+}
+
+BOOST_AUTO_TEST_CASE(data_base__backup__restore__success)
+{
+    data_base instance(file_path, false, false);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    BOOST_REQUIRE(instance.create(bc_settings.genesis_block));
+    BOOST_REQUIRE(instance.backup(DIRECTORY "/backup"));
+
+    // The second backup is incremental.
+    BOOST_REQUIRE(instance.backup(DIRECTORY "/backup"));
+    BOOST_CHECK(instance.close());
+
+    BOOST_REQUIRE(data_base::restore(DIRECTORY "/backup",
+        DIRECTORY "/restored"));
+
+    data_base copy(DIRECTORY "/restored", false, false);
+    BOOST_CHECK(copy.open());
+    BOOST_CHECK(copy.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__create__low_memory_preset__success)
+{
+    database::settings settings(database::settings::preset::low_memory);
+    settings.directory = file_path;
+    data_base instance(settings);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    BOOST_REQUIRE(instance.create(bc_settings.genesis_block));
+    BOOST_CHECK(instance.close());
+    BOOST_CHECK(instance.open());
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__open__disable_wal__writes_persisted)
+{
+    database::settings settings;
+    settings.directory = file_path;
+    settings.disable_wal = true;
+    data_base instance(settings);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    BOOST_REQUIRE(instance.create(genesis));
+    BOOST_CHECK(instance.close());
+    BOOST_REQUIRE(instance.open());
+
+    const auto context = instance.begin_transaction();
+    const auto result = instance.blocks().get(context, 0, false);
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE(result.hash() == genesis.hash());
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__open__tiered__genesis_available)
+{
+    database::settings settings;
+    settings.directory = file_path;
+    settings.data_paths =
+    {
+        { DIRECTORY "/fast", 1024 * 1024 },
+        { DIRECTORY "/slow", max_uint64 }
+    };
+    settings.family_paths["blocks"] = { { DIRECTORY "/fast", max_uint64 } };
+    data_base instance(settings);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    BOOST_REQUIRE(instance.create(genesis));
+    BOOST_REQUIRE(!instance.backup(DIRECTORY "/backup"));
+    BOOST_CHECK(instance.close());
+    BOOST_REQUIRE(instance.open());
+
+    const auto context = instance.begin_transaction();
+    const auto result = instance.blocks().get(context, 0, false);
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE(result.hash() == genesis.hash());
+    BOOST_CHECK(instance.close());
+}
+
+BOOST_AUTO_TEST_CASE(data_base__compact__prune_depth__genesis_pruned)
+{
+    database::settings settings;
+    settings.directory = file_path;
+    settings.prune_depth = 1;
+    settings.verify_depth = 1;
+    data_base instance(settings);
+
+    const auto bc_settings = bc::system::settings(config::settings::mainnet);
+    const chain::block& genesis = bc_settings.genesis_block;
+    const auto& coinbase = genesis.transactions().front();
+    BOOST_REQUIRE(instance.create(genesis));
+
+    // Each coinbase is made unique by its lock time.
+    auto previous = genesis.hash();
+    for (uint32_t height = 1; height <= 2; ++height)
+    {
+        const chain::transaction next(1, height,
+            { { { null_hash, point::null_index }, {}, 0 } },
+            coinbase.outputs());
+        const chain::header header(1, previous, next.hash(), height, 0, 0);
+        const chain::block block(header, { next });
+        previous = block.hash();
+
+        const auto context = instance.begin_transaction();
+        BOOST_REQUIRE_EQUAL(instance.push(context, block, height),
+            error::success);
+        BOOST_REQUIRE(instance.commit_transaction(context));
+    }
+
+    // Blocks below the top are prunable once opened at the top.
+    BOOST_REQUIRE(instance.close());
+    BOOST_REQUIRE(instance.open());
+    BOOST_REQUIRE(instance.compact());
+
+    const auto context = instance.begin_transaction();
+    const auto tx = instance.transactions().get(context, coinbase.hash());
+    BOOST_REQUIRE(tx);
+    BOOST_REQUIRE(tx.pruned());
+    BOOST_REQUIRE(!tx.transaction().is_valid());
+    BOOST_REQUIRE(tx.output(0) == coinbase.outputs().front());
+
+    const auto pruned = instance.blocks().get(context, 0, false);
+    BOOST_REQUIRE(pruned);
+    BOOST_REQUIRE_EQUAL(pruned.transaction_count(), 0u);
+
+    const auto top = instance.blocks().get(context, 2, false);
+    BOOST_REQUIRE(top);
+    BOOST_REQUIRE_EQUAL(top.transaction_count(), 1u);
+    BOOST_CHECK(instance.close());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::database;
+using namespace bc::system;
+
+static const uint32_t expiry = 100;
+static const data_chunk body{ 0x01, 0x02, 0x03 };
+
+BOOST_AUTO_TEST_SUITE(memory_pool_tests)
+
+BOOST_AUTO_TEST_CASE(memory_pool__find__added__expected)
+{
+    memory_pool instance(expiry);
+    instance.add(null_hash, 42, body, 1000);
+
+    uint32_t forks;
+    data_chunk out_body;
+    BOOST_REQUIRE(instance.find(null_hash, forks, out_body, 1000));
+    BOOST_REQUIRE_EQUAL(forks, 42u);
+    BOOST_REQUIRE(out_body == body);
+}
+
+BOOST_AUTO_TEST_CASE(memory_pool__find__expired__false)
+{
+    memory_pool instance(expiry);
+    instance.add(null_hash, 42, body, 1000);
+
+    uint32_t forks;
+    data_chunk out_body;
+    BOOST_REQUIRE(!instance.find(null_hash, forks, out_body, 1000 + expiry));
+}
+
+BOOST_AUTO_TEST_CASE(memory_pool__add__expired_entries__removed)
+{
+    memory_pool instance(expiry);
+    instance.add(null_hash, 42, body, 1000);
+    instance.add(hash_literal(
+        "0000000000000000000000000000000000000000000000000000000000000001"),
+        42, body, 1000 + expiry);
+
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(memory_pool__remove__added__not_found)
+{
+    memory_pool instance(expiry);
+    instance.add(null_hash, 42, body, 1000);
+    instance.remove(null_hash);
+
+    uint32_t forks;
+    data_chunk out_body;
+    BOOST_REQUIRE(!instance.find(null_hash, forks, out_body, 1000));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(memory_pool__add__over_capacity__oldest_evicted)
+{
+    static const auto second = hash_literal(
+        "0000000000000000000000000000000000000000000000000000000000000001");
+
+    memory_pool instance(expiry);
+    instance.add(null_hash, 42, body, 1000);
+    const auto entry = instance.bytes();
+
+    memory_pool bounded(expiry, entry);
+    bounded.add(null_hash, 42, body, 1000);
+    bounded.add(second, 42, body, 1001);
+
+    uint32_t forks;
+    data_chunk out_body;
+    BOOST_REQUIRE_EQUAL(bounded.size(), 1u);
+    BOOST_REQUIRE_EQUAL(bounded.bytes(), entry);
+    BOOST_REQUIRE(!bounded.find(null_hash, forks, out_body, 1001));
+    BOOST_REQUIRE(bounded.find(second, forks, out_body, 1001));
+}
+
+BOOST_AUTO_TEST_CASE(memory_pool__remove__added__no_bytes)
+{
+    memory_pool instance(expiry);
+    instance.add(null_hash, 42, body, 1000);
+    BOOST_REQUIRE(instance.bytes() > body.size());
+
+    instance.remove(null_hash);
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
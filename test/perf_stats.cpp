@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::database;
+
+BOOST_AUTO_TEST_SUITE(perf_stats_tests)
+
+BOOST_AUTO_TEST_CASE(perf_stats__sample__disabled__counted_not_sampled)
+{
+    perf_stats instance(0, 0);
+    BOOST_REQUIRE(!instance.enabled());
+
+    {
+        const perf_stats::sample sample(instance, perf_stats::commit);
+    }
+
+    const auto totals = instance.get(perf_stats::commit);
+    BOOST_REQUIRE_EQUAL(totals.calls, 1u);
+    BOOST_REQUIRE_EQUAL(totals.samples, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(perf_stats__sample__rate_two__every_second_sampled)
+{
+    perf_stats instance(2, 0);
+    BOOST_REQUIRE(instance.enabled());
+
+    for (auto call = 0; call < 5; ++call)
+        const perf_stats::sample sample(instance, perf_stats::get_block);
+
+    const auto totals = instance.get(perf_stats::get_block);
+    BOOST_REQUIRE_EQUAL(totals.calls, 5u);
+    BOOST_REQUIRE_EQUAL(totals.samples, 2u);
+    BOOST_REQUIRE_EQUAL(instance.get(perf_stats::commit).calls, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(perf_stats__sample__nested__inner_skipped)
+{
+    perf_stats instance(1, 0);
+
+    {
+        const perf_stats::sample outer(instance, perf_stats::commit);
+        const perf_stats::sample inner(instance, perf_stats::get_output);
+    }
+
+    BOOST_REQUIRE_EQUAL(instance.get(perf_stats::commit).samples, 1u);
+    BOOST_REQUIRE_EQUAL(instance.get(perf_stats::get_output).samples, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
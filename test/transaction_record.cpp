@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::database;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+#define TRANSACTION1 "0100000001537c9d05b5f7d67b09e5108e3bd5e466909cc9403ddd98bc42973f366fe729410600000000ffffffff0163000000000000001976a914fe06e7b4c88a719e92373de489c08244aee4520b88ac00000000"
+#define WITNESS_TRANSACTION "01000000000101ad0c2f5e2a7bd0f2d1e7c1cda2a6e1bbb3bc34b0d18e1e3a4a2e4cbd5a0ba6e50000000000ffffffff0240420f000000000016001479091972186c449eb1ded22b78e40d009bdf00892202000000000000225120a60869f0dbcf1dc659c9cecbaf8050135ea9e8cdc487053f1dc6880949dc684c0247304402201f6e9fda3f1d5c7d8c5b6bd5e5d6fe0f4fcf2e2bc1e8e1b7c7c54a7c2bd0a9d502203d8e5c4c6c8d7e5b5e8a0c1f8b2c5c6e7d7c9f9e9a5e3d7b9b1c4e2f8a7b6c5d012102f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f900000000"
+
+BOOST_AUTO_TEST_SUITE(transaction_record_tests)
+
+BOOST_AUTO_TEST_CASE(transaction_record__compress_amount__round_trip__expected)
+{
+    for (const uint64_t value: { 0ull, 1ull, 10ull, 99ull, 50000000ull,
+        123456789ull, 2100000000000000ull })
+    {
+        const auto compressed = transaction_record::compress_amount(value);
+        BOOST_REQUIRE_EQUAL(transaction_record::expand_amount(compressed),
+            value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(transaction_record__compress_amount__whole_coin__small)
+{
+    BOOST_REQUIRE_LT(transaction_record::compress_amount(50000000), 0x80u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_record__compress_script__pay_key_hash__tag_and_hash)
+{
+    const auto script = to_chunk(base16_literal(
+        "76a914fe06e7b4c88a719e92373de489c08244aee4520b88ac"));
+    const auto compressed = transaction_record::compress_script(script);
+    BOOST_REQUIRE_EQUAL(compressed.size(), 21u);
+    BOOST_REQUIRE_EQUAL(compressed.front(),
+        transaction_record::pay_key_hash);
+
+    auto source = make_safe_deserializer(compressed.begin(),
+        compressed.end());
+    BOOST_REQUIRE(transaction_record::expand_script(source) == script);
+    BOOST_REQUIRE(source);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_record__compress_script__nonstandard__raw)
+{
+    const auto script = to_chunk(base16_literal("6a0401020304"));
+    const auto compressed = transaction_record::compress_script(script);
+    BOOST_REQUIRE_EQUAL(compressed.front(), transaction_record::raw);
+
+    auto source = make_safe_deserializer(compressed.begin(),
+        compressed.end());
+    BOOST_REQUIRE(transaction_record::expand_script(source) == script);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_record__factory__legacy__byte_identical)
+{
+    data_chunk wire;
+    BOOST_REQUIRE(decode_base16(wire, TRANSACTION1));
+    const auto tx = transaction::factory(wire, true, true);
+    BOOST_REQUIRE(tx.is_valid());
+
+    const auto record = transaction_record::to_data(tx);
+    BOOST_REQUIRE_LT(record.size(), wire.size());
+
+    const auto decoded = transaction_record::factory(record);
+    BOOST_REQUIRE(decoded.is_valid());
+    BOOST_REQUIRE(decoded.to_data(true, true) == wire);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_record__factory__witness__byte_identical)
+{
+    data_chunk wire;
+    BOOST_REQUIRE(decode_base16(wire, WITNESS_TRANSACTION));
+    const auto tx = transaction::factory(wire, true, true);
+    BOOST_REQUIRE(tx.is_valid());
+    BOOST_REQUIRE(tx.is_segregated());
+
+    const auto decoded = transaction_record::factory(
+        transaction_record::to_data(tx));
+    BOOST_REQUIRE(decoded.to_data(true, true) == wire);
+    BOOST_REQUIRE(decoded.hash() == tx.hash());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_record__factory__truncated__invalid)
+{
+    data_chunk wire;
+    BOOST_REQUIRE(decode_base16(wire, TRANSACTION1));
+    auto record = transaction_record::to_data(
+        transaction::factory(wire, true, true));
+    record.resize(record.size() / 2);
+    BOOST_REQUIRE(!transaction_record::factory(record).is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_record__to_pruned__witness__outputs_retained)
+{
+    data_chunk wire;
+    BOOST_REQUIRE(decode_base16(wire, WITNESS_TRANSACTION));
+    const auto tx = transaction::factory(wire, true, true);
+    const auto record = transaction_record::to_data(tx);
+    BOOST_REQUIRE(!transaction_record::is_pruned(record));
+
+    const auto pruned = transaction_record::to_pruned(record);
+    BOOST_REQUIRE(transaction_record::is_pruned(pruned));
+    BOOST_REQUIRE_LT(pruned.size(), record.size());
+
+    const auto decoded = transaction_record::factory(pruned);
+    BOOST_REQUIRE(decoded.inputs().empty());
+    BOOST_REQUIRE(decoded.outputs() == tx.outputs());
+}
+
+BOOST_AUTO_TEST_CASE(transaction_record__to_pruned__truncated__empty)
+{
+    data_chunk wire;
+    BOOST_REQUIRE(decode_base16(wire, TRANSACTION1));
+    auto record = transaction_record::to_data(
+        transaction::factory(wire, true, true));
+    record.resize(record.size() / 2);
+    BOOST_REQUIRE(transaction_record::to_pruned(record).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
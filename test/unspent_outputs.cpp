@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::database;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+#define TRANSACTION1 "0100000001537c9d05b5f7d67b09e5108e3bd5e466909cc9403ddd98bc42973f366fe729410600000000ffffffff0163000000000000001976a914fe06e7b4c88a719e92373de489c08244aee4520b88ac00000000"
+
+static transaction make_tx()
+{
+    transaction tx;
+    tx.from_data(to_chunk(base16_literal(TRANSACTION1)));
+    return tx;
+}
+
+BOOST_AUTO_TEST_SUITE(unspent_outputs_tests)
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__spend__fork_below_spender__unspent)
+{
+    const auto tx = make_tx();
+    const output_point point{ tx.hash(), 0 };
+    unspent_outputs instance(10, 5);
+    instance.add(tx, 100, 0, true);
+    instance.spend(point, 101);
+
+    BOOST_REQUIRE(instance.populate(point, 100));
+    BOOST_REQUIRE(point.metadata.confirmed);
+    BOOST_REQUIRE(!point.metadata.confirmed_spent);
+
+    BOOST_REQUIRE(instance.populate(point, 101));
+    BOOST_REQUIRE(point.metadata.confirmed_spent);
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__spend__beyond_window__removed)
+{
+    const auto tx = make_tx();
+    const output_point point{ tx.hash(), 0 };
+    unspent_outputs instance(10, 5);
+    instance.add(tx, 100, 0, true);
+    instance.spend(point, 101);
+    instance.spend(output_point{ null_hash, 0 }, 106);
+
+    BOOST_REQUIRE(!instance.populate(point, 106));
+    BOOST_REQUIRE(instance.empty());
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__spend__zero_window__removed)
+{
+    const auto tx = make_tx();
+    const output_point point{ tx.hash(), 0 };
+    unspent_outputs instance(10);
+    instance.add(tx, 100, 0, true);
+    instance.spend(point, 101);
+
+    BOOST_REQUIRE(!instance.populate(point, 100));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__unconfirm__spender__unspent)
+{
+    const auto tx = make_tx();
+    const output_point point{ tx.hash(), 0 };
+    const transaction spender(1, 0, { { point, {}, 0 } }, {});
+    unspent_outputs instance(10, 5);
+    instance.add(tx, 100, 0, true);
+    instance.spend(point, 101);
+
+    // The spender and then the tx are reorganized out.
+    instance.unconfirm(spender);
+    BOOST_REQUIRE(instance.populate(point, 101));
+    BOOST_REQUIRE(!point.metadata.confirmed_spent);
+    BOOST_REQUIRE(point.metadata.confirmed);
+
+    instance.unconfirm(tx);
+    BOOST_REQUIRE(instance.populate(point, 101));
+    BOOST_REQUIRE(!point.metadata.confirmed);
+
+    // Reconfirmation replaces the unconfirmed entry.
+    instance.add(tx, 102, 0, true);
+    BOOST_REQUIRE(instance.populate(point, 102));
+    BOOST_REQUIRE(point.metadata.confirmed);
+    BOOST_REQUIRE_EQUAL(point.metadata.height, 102u);
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__add_block__pooled__promoted)
+{
+    const auto tx = make_tx();
+    const output_point point{ tx.hash(), 0 };
+    unspent_outputs instance(10);
+    instance.add(tx, 0, 0, false);
+
+    block block;
+    block.set_transactions({ tx });
+    instance.add(block, 100, 42);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.populate(point, 100));
+    BOOST_REQUIRE(point.metadata.confirmed);
+    BOOST_REQUIRE_EQUAL(point.metadata.height, 100u);
+    BOOST_REQUIRE_EQUAL(point.metadata.median_time_past, 42u);
+
+    // A confirmed tx is not demoted.
+    instance.add(tx, 0, 0, false);
+    BOOST_REQUIRE(instance.populate(point, 100));
+    BOOST_REQUIRE(point.metadata.confirmed);
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__confirmed__retains_spent)
+{
+    const auto prior = make_tx();
+    const transaction tx(1, 0, prior.inputs(), { { 1, {} }, { 2, {} } });
+    const output_point point{ tx.hash(), 0 };
+    unspent_outputs instance(10);
+    instance.add(tx, 100, 0, true);
+    instance.remove(point);
+    BOOST_REQUIRE(!instance.populate(point));
+    BOOST_REQUIRE(instance.populate(output_point{ tx.hash(), 1 }));
+
+    // Promotion after rollback does not restore the removed output.
+    instance.unconfirm(tx);
+    instance.add(tx, 101, 0, true);
+    BOOST_REQUIRE(!instance.populate(point));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__apply_revert__spender_block__round_trip)
+{
+    const auto tx = make_tx();
+    const output_point point{ tx.hash(), 0 };
+    const transaction coinbase(1, 0,
+        { { output_point{ null_hash, output_point::null_index }, {}, 0 } },
+        { { 1, {} } });
+    const transaction spender(1, 0, { { point, {}, 0 } }, { { 1, {} } });
+    const output_point spender_point{ spender.hash(), 0 };
+    unspent_outputs instance(10, 5);
+    instance.add(tx, 100, 0, true);
+
+    block block;
+    block.set_transactions({ coinbase, spender });
+    instance.apply(block, 101, 0);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE(instance.populate(point, 101));
+    BOOST_REQUIRE(point.metadata.confirmed_spent);
+    BOOST_REQUIRE(instance.populate(spender_point, 101));
+    BOOST_REQUIRE(spender_point.metadata.confirmed);
+
+    instance.revert(block);
+    BOOST_REQUIRE(instance.populate(point, 101));
+    BOOST_REQUIRE(!point.metadata.confirmed_spent);
+    BOOST_REQUIRE(instance.populate(spender_point, 101));
+    BOOST_REQUIRE(!spender_point.metadata.confirmed);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
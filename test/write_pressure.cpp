@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::database;
+
+static rocksdb::WriteStallInfo stall_info(const std::string& family,
+    rocksdb::WriteStallCondition condition)
+{
+    rocksdb::WriteStallInfo info;
+    info.cf_name = family;
+    info.condition.cur = condition;
+    info.condition.prev = rocksdb::WriteStallCondition::kNormal;
+    return info;
+}
+
+BOOST_AUTO_TEST_SUITE(write_pressure_tests)
+
+BOOST_AUTO_TEST_CASE(write_pressure__construct__normal)
+{
+    const write_pressure instance;
+    BOOST_REQUIRE_EQUAL(instance.condition(), write_pressure::normal);
+    BOOST_REQUIRE(!instance.backpressure(0));
+    BOOST_REQUIRE(instance.wait(0, std::chrono::milliseconds(0)));
+}
+
+BOOST_AUTO_TEST_CASE(write_pressure__stall__worst_family__backpressure)
+{
+    write_pressure instance;
+    instance.OnStallConditionsChanged(stall_info("blocks",
+        rocksdb::WriteStallCondition::kDelayed));
+    instance.OnStallConditionsChanged(stall_info("payments",
+        rocksdb::WriteStallCondition::kStopped));
+
+    BOOST_REQUIRE_EQUAL(instance.condition(), write_pressure::stopped);
+    BOOST_REQUIRE(instance.backpressure(0));
+    BOOST_REQUIRE(!instance.wait(0, std::chrono::milliseconds(1)));
+
+    instance.OnStallConditionsChanged(stall_info("payments",
+        rocksdb::WriteStallCondition::kNormal));
+    BOOST_REQUIRE_EQUAL(instance.condition(), write_pressure::delayed);
+    BOOST_REQUIRE(instance.wait(0, std::chrono::milliseconds(0)));
+
+    instance.OnStallConditionsChanged(stall_info("blocks",
+        rocksdb::WriteStallCondition::kNormal));
+    BOOST_REQUIRE(!instance.backpressure(0));
+
+    const auto counters = instance.get();
+    BOOST_REQUIRE_EQUAL(counters.delays, 1u);
+    BOOST_REQUIRE_EQUAL(counters.stops, 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()